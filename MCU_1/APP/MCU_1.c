@@ -12,6 +12,7 @@
 
 #include <avr/io.h>
 #include <avr/interrupt.h>
+#include <avr/pgmspace.h>
 #include "..\common_macros.h"
 #include "../MCAL/gpio.h"
 #include "../HAL/lm35_sensor.h"
@@ -19,42 +20,134 @@
 #include "../MCAL/internal_EEPROM.h"
 #include "../HAL/button.h"
 #include "../HAL/dc_motor.h"
+#include "../HAL/tachometer.h"
+#include "../HAL/current_sensor.h"
 #include "../MCAL/adc.h"
-#include "../MCAL/timer1.h"
 #include <avr/delay.h>
 #include "../MCAL/WDT.h"
+#include "../MCAL/reset.h"
+#include "../MCAL/profile.h"
+#include "../SERVICE/scheduler.h"
+#include "../SERVICE/timebase.h"
+#include "../SERVICE/soft_timer.h"
+#include "../SERVICE/event_log.h"
+#include "../SERVICE/nvm_layout.h"
+#include "../SERVICE/config.h"
+#include "../SERVICE/pid.h"
+#include "../SERVICE/fan_curve.h"
+#include "../SERVICE/band.h"
+#include "../SERVICE/link.h"
 
 /* Definitions for various system states */
 #define NORMAL_STATE 0
 #define EMERGENCY_STATE 1
 #define ABNORMAL_STATE 2
 #define SHUTDOWN_STATE 3
+#define FAN_FAULT_STATE 4      /* Fan cut by the current protection */
 
 /* Special codes for communication */
 #define SHUTDOWN_CODE 0xFF
 #define ABNORMAL_CODE 0xFE
 
+/* Fan stall detection */
+#define FAN_STALL_MIN_SPEED		1	/* Every non zero speed turns the fan, it is kept above its minimum duty */
+#define FAN_STALL_CHECKS		20	/* Control periods stalled in a row, 2 seconds */
+
+/* Fan current protection */
+#define FAN_TRIP_CURRENT		4000	/* mA, a shorted fan or driver, cut in the ADC interrupt */
+#define FAN_STALL_CURRENT		2000	/* mA, a jammed fan draws about its stall current */
+#define FAN_STALL_CURRENT_TIME	1000	/* ms above the stall current, longer than the start-up inrush */
+#define FAN_FAULT_RETRY_TIME	5000	/* ms the fan stays off before it is tried again */
+#define FAN_FAULT_RETRIES		3		/* Faults in a row after which the fan stays off */
+#define FAN_FAULT_CLEAR_TIME	60000	/* ms without a fault that end a row of faults */
+
+/* Temperature bands, see updateTemperatureBands */
+#define BAND_FAN_CONTROL		0	/* Below the fan full temperature, the controller drives the fan */
+#define BAND_FAN_FULL			1	/* Fan full temperature up to the emergency temperature */
+#define BAND_EMERGENCY			2	/* Above the emergency temperature */
+#define BAND_THRESHOLDS			2
+#define BAND_HYSTERESIS			2		/* Degrees below a threshold to leave its band */
+#define BAND_DWELL_TIME			1000	/* ms the temperature has to stay in a new band */
+#define BAND_EMERGENCY_DWELL_TIME	300	/* Shorter, the emergency must not wait long */
+
+/* Motor duty ramp, limits the inrush current: 0 to full speed in about half a second */
+#define MOTOR_RAMP_STEP			4		/* Permille per Timer0 PWM period (2ms) */
+
+/* Motor compensation, the fan does not turn below about 25% duty */
+#define MOTOR_MIN_DUTY			250		/* Permille, lowest duty of a non zero speed */
+#define MOTOR_KICK_DUTY			600		/* Permille given from standstill */
+#define MOTOR_KICK_TICKS		50		/* Timer0 PWM periods, about 100ms */
+
+/* Shutdown button, known by its external interrupt line */
+#define SHUTDOWN_BUTTON_LINE	EXTI_INT0
+
+/* Motor handles, the index in motorConfig */
+#define FAN_MOTOR				0
+
+/* Task periods and first release offsets in milliseconds */
+#define SENSOR_TASK_PERIOD		20		/* 50Hz */
+#define CONTROL_TASK_PERIOD		100		/* 10Hz */
+#define TELEMETRY_TASK_PERIOD	500		/* 2Hz */
+#define SERVICE_TASK_PERIOD		20		/* 50Hz */
+#define SENSOR_TASK_OFFSET		0
+#define CONTROL_TASK_OFFSET		10
+#define TELEMETRY_TASK_OFFSET	30
+#define SERVICE_TASK_OFFSET		50
+
+/* Emergency ticks between two saves of the emergency counters, limits the EEPROM wear */
+#define EMERGENCY_SAVE_TICKS	4
+
+/* Time in ms allowed between two bytes of a frame from the diagnostic tool */
+#define SERVICE_FRAME_TIMEOUT	100
+
 /* Global variables */
 volatile uint8 temperature;          /* Current temperature value */
 volatile uint8 emergencyTIME = 0;    /* Timer counter for emergency state */
 volatile uint8 state = NORMAL_STATE; /* Current system state */
-volatile uint8 buttonPressed = 0;    /* Flag for button press */
+uint32 emergencyStartTime = 0;       /* Time in ms at which the emergency state was entered */
+uint8 emergencyPeakTemperature = 0;  /* Highest temperature seen during the emergency state */
+uint8 emergencySavedPeak = 0;        /* Peak temperature last saved in EEPROM */
+uint8 fanSpeed = 0;                  /* Fan duty in percent */
+uint8 fanStallCount = 0;             /* Control periods the driven fan was seen stalled */
+uint8 fanFaultCount = 0;             /* Current faults in a row */
+boolean fanFaultActive = FALSE;      /* TRUE while a current fault keeps the fan off */
+uint32 fanFaultTime = 0;             /* Time in ms of the last current fault */
+Pid_ControllerType fanPid;           /* Holds the temperature at the target in the normal state */
+const Config_Type *config;           /* Runtime configuration loaded from EEPROM */
+Band_ThresholdType temperatureThresholds[BAND_THRESHOLDS]; /* Taken from the configuration */
+Band_ClassifierType temperatureBand; /* Band of the temperature, changes only on real crossings */
+Link_ReceiverType serviceLink;       /* Frames from the diagnostic tool, see link.h */
+uint32 serviceLastTime = 0;          /* Time in ms of the task run that took the last tool byte */
+
+/* Motors driven by this MCU, kept in flash */
+/* Fan duty in permille for 0%, 10% ... 100% of the airflow, measured on the fan */
+const uint16 fanCalibration[DC_MOTOR_CALIBRATION_POINTS] PROGMEM = {
+	250, 300, 360, 420, 480, 550, 620, 700, 790, 890, 1000
+};
+
+const DcMotor_ConfigType motorConfig[] PROGMEM = {
+	{PORTB_ID, PIN1_ID, PORTB_ID, PIN2_ID, DC_MOTOR_PWM_TIMER0, 0, MOTOR_RAMP_STEP,
+	 MOTOR_MIN_DUTY, MOTOR_KICK_DUTY, MOTOR_KICK_TICKS, fanCalibration} /* Timer1 is the tachometer's */
+};
 
 /******************************************************************************
- * Service Name: INT0_vect ISR
- * Sync/Async: Asynchronous
+ * Service Name: updateTemperatureBands
+ * Sync/Async: Synchronous
  * Reentrancy: Non-reentrant
  * Parameters (in): None
  * Parameters (inout): None
  * Parameters (out): None
  * Return value: None
- * Description: Interrupt Service Routine for INT0. Sends shutdown code via UART
- *              if the temperature is in the shutdown range.
+ * Description: Sets the band thresholds from the configuration in use, the
+ *              emergency band starts above the emergency temperature.
  *******************************************************************************/
-ISR(INT0_vect) {
-	if (temperature >= 40 && temperature <= 50) {
-		UART_sendByte(SHUTDOWN_CODE);
-	}
+void updateTemperatureBands(void) {
+	temperatureThresholds[0].threshold = config->fanFullTemperature;
+	temperatureThresholds[0].hysteresis = BAND_HYSTERESIS;
+	temperatureThresholds[0].dwellMs = BAND_DWELL_TIME;
+	temperatureThresholds[1].threshold = config->emergencyTemperature + 1;
+	temperatureThresholds[1].hysteresis = BAND_HYSTERESIS;
+	temperatureThresholds[1].dwellMs = BAND_EMERGENCY_DWELL_TIME;
 }
 
 /******************************************************************************
@@ -65,11 +158,23 @@ ISR(INT0_vect) {
  * Parameters (inout): None
  * Parameters (out): None
  * Return value: None
- * Description: Increments the emergency timer if the system is in emergency state.
+ * Description: Increments the emergency timer if the system is in emergency
+ *              state. Every EMERGENCY_SAVE_TICKS ticks the count, and the peak
+ *              temperature if it rose, are saved so an emergency resumes about
+ *              where it stopped: a reset loses at most the ticks since the last
+ *              save, which only makes the emergency last longer.
  *******************************************************************************/
 void emergencyTick(void) {
 	if (state == EMERGENCY_STATE) {
 		emergencyTIME++;
+		if ((emergencyTIME % EMERGENCY_SAVE_TICKS) == 0) {
+			uint8 ticks = emergencyTIME;
+			INTERNAL_EEPROM_writeBlockAsync(NVM_EMERGENCY_TIME_ADDRESS, &ticks, 1);
+			if ((emergencyPeakTemperature != emergencySavedPeak) &&
+					INTERNAL_EEPROM_writeBlockAsync(NVM_EMERGENCY_PEAK_ADDRESS, &emergencyPeakTemperature, 1)) {
+				emergencySavedPeak = emergencyPeakTemperature;
+			}
+		}
 	}
 	else
 	{
@@ -78,25 +183,485 @@ void emergencyTick(void) {
 }
 
 /******************************************************************************
- * Service Name: mapToPercentage
+ * Service Name: setFanSpeed
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-reentrant
+ * Parameters (in): speed - Fan duty in percent, 0 stops the fan
+ * Parameters (inout): None
+ * Parameters (out): None
+ * Return value: None
+ * Description: Drives the fan and keeps its duty for the stall check. While
+ *              the current protection inhibits the fan its duty is 0.
+ *******************************************************************************/
+void setFanSpeed(uint8 speed) {
+	if (DcMotor_isInhibited(FAN_MOTOR)) {
+		speed = 0;
+	}
+	fanSpeed = speed;
+	DcMotor_Rotate(FAN_MOTOR, (speed == 0) ? COAST : FORWARD, speed);
+}
+
+/******************************************************************************
+ * Service Name: setFanFull
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-reentrant
+ * Parameters (in): None
+ * Parameters (inout): None
+ * Parameters (out): None
+ * Return value: None
+ * Description: Emergency override, the fan gets the full duty at once instead
+ *              of the start-up kick and the ramp of setFanSpeed. The inhibit
+ *              of the current protection still holds the fan off.
+ *******************************************************************************/
+void setFanFull(void) {
+	setFanSpeed(100);
+	DcMotor_setDuty(FAN_MOTOR, DC_MOTOR_DUTY_MAX);
+}
+
+/******************************************************************************
+ * Service Name: checkFan
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-reentrant
+ * Parameters (in): None
+ * Parameters (inout): None
+ * Parameters (out): None
+ * Return value: None
+ * Description: Updates the fan speed measurement and logs one stall event when
+ *              the driven fan stays stalled for FAN_STALL_CHECKS periods.
+ *******************************************************************************/
+void checkFan(void) {
+	Tacho_update();
+
+	if (fanSpeed >= FAN_STALL_MIN_SPEED && Tacho_isStalled()) {
+		if (fanStallCount < FAN_STALL_CHECKS) {
+			fanStallCount++;
+			if (fanStallCount == FAN_STALL_CHECKS) {
+				EventLog_record(EVENT_FAN_STALL, Time_nowMs(), temperature, 0);
+			}
+		}
+	}
+	else {
+		fanStallCount = 0;
+	}
+}
+
+/******************************************************************************
+ * Service Name: fanControl
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-reentrant
+ * Parameters (in): None
+ * Parameters (inout): None
+ * Parameters (out): None
+ * Return value: uint8 - Fan duty in percent
+ * Description: Runs one step of the fan controller, called at the control task
+ *              rate. The fan curve gives the duty of the temperature and the
+ *              PID trims it to hold the target temperature. With all the gains
+ *              set to 0 the fan follows the curve alone.
+ *              The PID step is the section measured in PROFILE_SECTIONS builds.
+ *******************************************************************************/
+uint8 fanControl(void) {
+	sint16 duty;
+	uint8 feed_forward = FanCurve_getDuty(temperature);
+
+	PROFILE_BEGIN();
+	duty = Pid_step(&fanPid, config->targetTemperature, temperature, feed_forward);
+	PROFILE_END();
+
+	return (uint8)duty;
+}
+
+/******************************************************************************
+ * Service Name: logEmergencyEnd
+ * Sync/Async: Asynchronous
+ * Reentrancy: Non-reentrant
+ * Parameters (in): type - How the emergency state ended
+ * Parameters (inout): None
+ * Parameters (out): None
+ * Return value: None
+ * Description: Logs the emergency that just ended with its start tick, peak
+ *              temperature and duration.
+ *******************************************************************************/
+void logEmergencyEnd(EventLog_EventType type) {
+	EventLog_record(type, emergencyStartTime, emergencyPeakTemperature, emergencyTIME);
+}
+
+/******************************************************************************
+ * Service Name: restoreState
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-reentrant
+ * Parameters (in): cause - The source of the last reset
+ * Parameters (inout): None
+ * Parameters (out): None
+ * Return value: None
+ * Description: Restores the control state and emergency counters saved before
+ *              the reset. An emergency resumes with its elapsed time, peak
+ *              temperature and start time, and the fan at full speed. The start
+ *              time stays the one of the run the emergency started in, like
+ *              the records logged before the reset. The abnormal state ends
+ *              with the deliberate watchdog reset, so after it the system
+ *              starts in the normal state. Any reset other than power-on is
+ *              logged. Called after Config_init.
+ *******************************************************************************/
+void restoreState(Reset_CauseType cause) {
+	state = INTERNAL_EEPROM_readByte(NVM_STATE_ADDRESS);
+
+	switch (state) {
+	case EMERGENCY_STATE:
+		emergencyTIME = INTERNAL_EEPROM_readByte(NVM_EMERGENCY_TIME_ADDRESS);
+		emergencyPeakTemperature = INTERNAL_EEPROM_readByte(NVM_EMERGENCY_PEAK_ADDRESS);
+		emergencySavedPeak = emergencyPeakTemperature;
+		INTERNAL_EEPROM_readBlock(NVM_EMERGENCY_START_ADDRESS, (uint8*)&emergencyStartTime, sizeof(emergencyStartTime));
+		setFanFull();
+		break;
+
+	case ABNORMAL_STATE:
+		if (cause == RESET_WATCHDOG) {
+			state = NORMAL_STATE;
+		}
+		else {
+			setFanFull();
+		}
+		break;
+
+	default:
+		state = NORMAL_STATE;
+		break;
+	}
+
+	INTERNAL_EEPROM_writeByte(NVM_STATE_ADDRESS, state);
+
+	switch (cause) {
+	case RESET_EXTERNAL:
+		EventLog_record(EVENT_EXTERNAL_RESET, Time_nowMs(), emergencyPeakTemperature, emergencyTIME);
+		break;
+	case RESET_BROWN_OUT:
+		EventLog_record(EVENT_BROWN_OUT_RESET, Time_nowMs(), emergencyPeakTemperature, emergencyTIME);
+		break;
+	case RESET_WATCHDOG:
+		EventLog_record(EVENT_WATCHDOG_RESET, Time_nowMs(), emergencyPeakTemperature, emergencyTIME);
+		break;
+	default:
+		break;
+	}
+}
+
+/******************************************************************************
+ * Service Name: serviceCommandHandler
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-reentrant
+ * Parameters (in): command - The service command received over the UART
+ * Parameters (inout): None
+ * Parameters (out): None
+ * Return value: None
+ * Description: Executes the single byte service commands sent by a diagnostic
+ *              tool.
+ *******************************************************************************/
+void serviceCommandHandler(uint8 command) {
+	switch (command) {
+	case EVENT_LOG_DUMP_CMD:
+		EventLog_dump();
+		break;
+
+	case CONFIG_READ_CMD:
+		Config_send();
+		break;
+
+	default:
+		break;
+	}
+}
+
+/******************************************************************************
+ * Service Name: serviceFrameHandler
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-reentrant
+ * Parameters (in): None
+ * Parameters (inout): None
+ * Parameters (out): None
+ * Return value: None
+ * Description: Executes a link frame sent by a diagnostic tool, received with
+ *              a right checksum in serviceLink.
+ *******************************************************************************/
+void serviceFrameHandler(void) {
+	switch (serviceLink.type) {
+	case LINK_CONFIG_WRITE:
+		if ((serviceLink.length == sizeof(Config_Type)) &&
+				Config_update((const Config_Type*)serviceLink.payload)) {
+			Pid_setGains(&fanPid, config->pidKp, config->pidKi, config->pidKd);
+			updateTemperatureBands();
+		}
+		/* Answer with the configuration in use, MCU2 applies it as well */
+		Config_send();
+		break;
+
+	default:
+		break;
+	}
+}
+
+/******************************************************************************
+ * Service Name: setState
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-reentrant
+ * Parameters (in): newState - The state to move to
+ * Parameters (inout): None
+ * Parameters (out): None
+ * Return value: None
+ * Description: Changes the system state and saves it in EEPROM. The EEPROM is
+ *              only written when the state really changes.
+ *******************************************************************************/
+void setState(uint8 newState) {
+	if (state != newState) {
+		state = newState;
+		INTERNAL_EEPROM_writeByte(NVM_STATE_ADDRESS, newState);
+	}
+}
+
+/******************************************************************************
+ * Service Name: enterEmergency
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-reentrant
+ * Parameters (in): None
+ * Parameters (inout): None
+ * Parameters (out): None
+ * Return value: None
+ * Description: Starts the emergency timer, start time and peak temperature,
+ *              saves them and moves to the emergency state with the fan at
+ *              full duty at once.
+ *******************************************************************************/
+void enterEmergency(void) {
+	Pid_reset(&fanPid);
+	emergencyTIME = 0;
+	emergencyStartTime = Time_nowMs();
+	emergencyPeakTemperature = temperature;
+	emergencySavedPeak = temperature;
+	INTERNAL_EEPROM_writeByte(NVM_EMERGENCY_TIME_ADDRESS, emergencyTIME);
+	INTERNAL_EEPROM_writeByte(NVM_EMERGENCY_PEAK_ADDRESS, emergencyPeakTemperature);
+	INTERNAL_EEPROM_writeBlockAsync(NVM_EMERGENCY_START_ADDRESS, (const uint8*)&emergencyStartTime, sizeof(emergencyStartTime));
+	setState(EMERGENCY_STATE);
+	setFanFull();
+}
+
+/******************************************************************************
+ * Service Name: checkFanCurrent
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-reentrant
+ * Parameters (in): None
+ * Parameters (inout): None
+ * Parameters (out): None
+ * Return value: None
+ * Description: Filters the fan current and handles the faults latched by the
+ *              current sensor, which inhibits the fan until they are cleared.
+ *              A fault is logged once with its current and moves the normal
+ *              state to the fan fault state, the emergency and abnormal states
+ *              go on with the fan off. The fan is tried again after
+ *              FAN_FAULT_RETRY_TIME, after FAN_FAULT_RETRIES faults in a row
+ *              MCU2 is told the system is abnormal and the fan stays off.
+ *******************************************************************************/
+void checkFanCurrent(void) {
+	Current_FaultType fault;
+	uint16 current;
+	uint32 now = Time_nowMs();
+
+	Current_update();
+	fault = Current_getFault(&current);
+
+	if (fault == CURRENT_NO_FAULT) {
+		if (fanFaultCount != 0 && TIME_ELAPSED(now, fanFaultTime) >= FAN_FAULT_CLEAR_TIME) {
+			fanFaultCount = 0;
+		}
+		return;
+	}
+
+	if (fanFaultActive) {
+		if (fanFaultCount < FAN_FAULT_RETRIES && TIME_ELAPSED(now, fanFaultTime) >= FAN_FAULT_RETRY_TIME) {
+			fanFaultActive = FALSE;
+			Current_clearFault();
+			if (state == FAN_FAULT_STATE) {
+				setState(NORMAL_STATE);
+			}
+		}
+		return;
+	}
+
+	fanFaultActive = TRUE;
+	setFanSpeed(0);
+	EventLog_record((fault == CURRENT_OVERCURRENT) ? EVENT_FAN_OVERCURRENT : EVENT_FAN_JAMMED,
+			now, temperature, current);
+	fanFaultTime = now;
+	fanFaultCount++;
+	if (fanFaultCount == FAN_FAULT_RETRIES) {
+		UART_sendByte(ABNORMAL_CODE);
+	}
+	if (state == NORMAL_STATE) {
+		setState(FAN_FAULT_STATE);
+	}
+}
+
+/******************************************************************************
+ * Service Name: sensorTask
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-reentrant
+ * Parameters (in): None
+ * Parameters (inout): None
+ * Parameters (out): None
+ * Return value: None
+ * Description: 50Hz task, samples the temperature sensor.
+ *******************************************************************************/
+void sensorTask(void) {
+	temperature = LM35_getTemperature(); /* Read temperature from the sensor */
+}
+
+/******************************************************************************
+ * Service Name: controlTask
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-reentrant
+ * Parameters (in): None
+ * Parameters (inout): None
+ * Parameters (out): None
+ * Return value: None
+ * Description: 10Hz task, runs the state machine that drives the fan, checks
+ *              that the fan turns and draws a sane current and handles the
+ *              shutdown button. The state machine follows the temperature
+ *              band, so noise around a threshold does not switch it back and
+ *              forth.
+ *******************************************************************************/
+void controlTask(void) {
+	uint8 band = Band_update(&temperatureBand, temperature);
+	Button_EventType buttonEvent;
+
+	checkFan();
+	checkFanCurrent();
+
+	/* State machine handling different system states */
+	switch (state) {
+
+	case NORMAL_STATE:
+	{
+		/* The controller runs every period, so it takes over smoothly below full speed */
+		uint8 duty = fanControl();
+
+		if (band == BAND_FAN_CONTROL) {
+			setFanSpeed(duty);
+		}
+		else if (band == BAND_FAN_FULL) {
+			setFanSpeed(100);
+		}
+		else {
+			enterEmergency();
+		}
+		break;
+	}
+
+	case EMERGENCY_STATE:
+		/* Saved by emergencyTick */
+		if (temperature > emergencyPeakTemperature) {
+			emergencyPeakTemperature = temperature;
+		}
+
+		if (emergencyTIME >= config->emergencyTimeoutTicks) {
+			setState(ABNORMAL_STATE);
+			UART_sendByte(ABNORMAL_CODE);
+			logEmergencyEnd(EVENT_ABNORMAL);
+			break;
+		} else if (band != BAND_EMERGENCY) {
+			/* A fan cut during the emergency is still waiting for its retry */
+			setState(fanFaultActive ? FAN_FAULT_STATE : NORMAL_STATE);
+			logEmergencyEnd(EVENT_EMERGENCY);
+		}
+		setFanSpeed(100);
+		break;
+
+	case ABNORMAL_STATE:
+		emergencyTIME = 0;
+		setFanSpeed(100);
+		/* Let the event record reach the EEPROM before the watchdog resets the system */
+		if (!INTERNAL_EEPROM_isBusy()) {
+			WDT_ON(TIME_OUT_16MS); /* Enable Watchdog Timer */
+		}
+		break;
+
+	case FAN_FAULT_STATE:
+		/*
+		 * The fan stays off until checkFanCurrent tries it again, the
+		 * emergency is still timed so a fan that stays off ends abnormal
+		 */
+		if (band == BAND_EMERGENCY) {
+			enterEmergency();
+		}
+		break;
+
+	default:
+		break;
+	}
+
+	/* Shutdown button: sends the shutdown code if the temperature is in the shutdown range */
+	while (BUTTON_getEvent(&buttonEvent)) {
+		if (buttonEvent.line == SHUTDOWN_BUTTON_LINE && buttonEvent.kind == BUTTON_PRESS &&
+				band == BAND_FAN_FULL) {
+			UART_sendByte(SHUTDOWN_CODE);
+			EventLog_record(EVENT_SHUTDOWN_REQUEST, Time_nowMs(), temperature, 0);
+		}
+	}
+}
+
+/******************************************************************************
+ * Service Name: telemetryTask
  * Sync/Async: Synchronous
- * Reentrancy: Reentrant
- * Parameters (in): value - The input value to map
- *                  min1 - Minimum input range
- *                  max1 - Maximum input range
+ * Reentrancy: Non-reentrant
+ * Parameters (in): None
  * Parameters (inout): None
  * Parameters (out): None
- * Return value: int - Mapped value as a percentage (0-100)
- * Description: Maps a given value to a percentage based on the specified range.
+ * Return value: None
+ * Description: 2Hz task, sends the temperature and the fan speed to MCU2.
+ *              The RPM bytes can take any value, so they go in a frame.
  *******************************************************************************/
-int mapToPercentage(int value, int min1, int max1) {
+void telemetryTask(void) {
+	uint16 rpm = Tacho_getRpm();
+	uint8 payload[2];
 
-	if (value < min1) value = min1;
-	if (value > max1) value = max1;
+	UART_sendByte(temperature); /* Send temperature value via UART */
+	payload[0] = (uint8)rpm;
+	payload[1] = (uint8)(rpm >> 8);
+	Link_sendFrame(LINK_FAN_RPM, payload, sizeof(payload));
+}
 
-	int percentage = ((value - min1) * 100) / (max1 - min1);
+/******************************************************************************
+ * Service Name: serviceTask
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-reentrant
+ * Parameters (in): None
+ * Parameters (inout): None
+ * Parameters (out): None
+ * Return value: None
+ * Description: 50Hz task, handles the service commands and frames from the
+ *              diagnostic tool and sends the event log dump one frame per run.
+ *              The bytes of a frame are collected across the runs, a frame
+ *              the tool stops sending is dropped after SERVICE_FRAME_TIMEOUT.
+ *******************************************************************************/
+void serviceTask(void) {
+	uint8 data;
+	uint32 now = Time_nowMs();
+
+	if (TIME_ELAPSED(now, serviceLastTime) > SERVICE_FRAME_TIMEOUT) {
+		Link_resetReceiver(&serviceLink);
+	}
+
+	while (UART_tryReceiveByte(&data)) {
+		serviceLastTime = now;
+		switch (Link_receiveByte(&serviceLink, data)) {
+		case LINK_NOT_FRAME:
+			serviceCommandHandler(data);
+			break;
+		case LINK_FRAME_OK:
+			serviceFrameHandler();
+			break;
+		default:
+			break;
+		}
+	}
 
-	return percentage;
+	EventLog_process();
 }
 
 /******************************************************************************
@@ -107,107 +672,69 @@ int mapToPercentage(int value, int min1, int max1) {
  * Parameters (inout): None
  * Parameters (out): None
  * Return value: int - Returns 0 upon completion (unused in embedded systems)
- * Description: Main function for MCU1 application. Handles temperature monitoring,
- *              motor control, and state transitions based on system inputs.
+ * Description: Main function for MCU1 application. Initializes the drivers, then
+ *              runs the temperature monitoring, motor control and communication
+ *              tasks from the scheduler.
  *******************************************************************************/
 int main(void) {
+	Reset_CauseType reset_cause = RESET_getCause(); /* Read before anything else can reset again */
+
 	SREG |= (1<<7);  /* Enable global interrupts */
-	DcMotor_Init();  /* Initialize the DC motor */
+	Time_init();     /* Start the system time base */
+	Tacho_init();    /* Measure the fan speed, takes Timer1 */
+	DcMotor_Init(motorConfig, sizeof(motorConfig) / sizeof(motorConfig[0])); /* Initialize the DC motor */
 	ADC_init();      /* Initialize ADC */
 
+	/* Fan current protection, samples on the Timer0 PWM of the fan */
+	Current_ConfigType current_config;
+	current_config.motor = FAN_MOTOR;
+	current_config.tripCurrent = FAN_TRIP_CURRENT;
+	current_config.stallCurrent = FAN_STALL_CURRENT;
+	current_config.stallTime = FAN_STALL_CURRENT_TIME;
+	Current_init(&current_config);
+
+	EventLog_init(); /* Find where the next event record goes */
+	Config_init();   /* Load the runtime configuration from EEPROM */
+	config = Config_get();
+	restoreState(reset_cause); /* Re-enter the state saved before the reset */
+	FanCurve_init(); /* Use the fan curve programmed in the EEPROM, if any */
+	updateTemperatureBands();
+	Band_init(&temperatureBand, temperatureThresholds, BAND_THRESHOLDS);
+	Pid_init(&fanPid, 0, 100); /* Fan duty controller, 0 to 100 percent */
+	Pid_setGains(&fanPid, config->pidKp, config->pidKi, config->pidKd);
+
 	/* UART configuration and initialization */
 	UART_ConfigType uart_config;
-	uart_config.baud_rate = 9600;
+	uart_config.baud_rate = config->baudRate;
 	uart_config.bit_data = BITS_8;
 	uart_config.parity = NO_PARITY;
 	uart_config.stop_bit = STOP_BIT_1;
 	UART_init(&uart_config);
 
-	/* Button configuration and initialization */
+	Scheduler_init();
+
+	/* Shutdown button to ground on INT0, debounced on a software timer */
 	Button_ConfigType button_config;
 	button_config.pinNum = INT0_PIN_NUM;
 	button_config.portNum = INT0_PORT_NUM;
+	button_config.line = SHUTDOWN_BUTTON_LINE;
+	button_config.pressedLevel = LOGIC_LOW;
+	button_config.longPressTime = 0;
 	BUTTON_init(&button_config);
-	MCUCR |= (1<<ISC01); /* Set interrupt on falling edge */
-	GICR |= (1<<INT0);   /* Enable INT0 interrupt */
-	SET_BIT(PORTD, PIN2_ID); /* Enable pull-up resistor on INT0 pin */
-
-	/* Timer1 configuration and initialization */
-	Timer1_ConfigType timer_config;
-	timer_config.initial_value = 0;
-	timer_config.mode = COMPARE_MODE;
-	timer_config.prescaler = PRESCALER_1024;
-	timer_config.compare_value = 488;
-	Timer1_init(&timer_config);
-	Timer1_setCallBack(emergencyTick); /* Set callback function for Timer1 */
-
-	INTERNAL_EEPROM_writeByte(0x00, NORMAL_STATE); /* Initialize state in EEPROM */
-
-	while(1)
-	{
-		state = INTERNAL_EEPROM_readByte(0x00); /* Read the current state from EEPROM */
 
-		temperature = LM35_getTemperature(); /* Read temperature from the sensor */
-		UART_sendByte(temperature); /* Send temperature value via UART */
+	/* The emergency timer counts on a periodic software timer */
+	uint8 emergency_timer = SoftTimer_create(emergencyTick);
+	SoftTimer_start(emergency_timer, config->emergencyTickPeriod, config->emergencyTickPeriod);
 
-		/* State machine handling different system states */
-		switch (state) {
+	/* Register the tasks, highest priority first, and run them forever */
+	Scheduler_addTask(sensorTask, SENSOR_TASK_PERIOD, SENSOR_TASK_OFFSET);
+	Scheduler_addTask(controlTask, CONTROL_TASK_PERIOD, CONTROL_TASK_OFFSET);
+	Scheduler_addTask(telemetryTask, TELEMETRY_TASK_PERIOD, TELEMETRY_TASK_OFFSET);
+	Scheduler_addTask(serviceTask, SERVICE_TASK_PERIOD, SERVICE_TASK_OFFSET);
 
-		case NORMAL_STATE:
-			if (temperature <= 20)
-			{
-				INTERNAL_EEPROM_writeByte(0x00, NORMAL_STATE);
-				DcMotor_Rotate(STOP,0);
-				state = NORMAL_STATE;
-			}
-			else if (temperature >= 20 && temperature < 40) {
-				INTERNAL_EEPROM_writeByte(0x00, NORMAL_STATE);
-				DcMotor_Rotate(CLOCKWISE, mapToPercentage(temperature, 20, 40));
-				state = NORMAL_STATE;
-			}
-			else if (temperature >= 40 && temperature <= 50) {
-				INTERNAL_EEPROM_writeByte(0x00, NORMAL_STATE);
-				DcMotor_Rotate(CLOCKWISE, 100);
-				state = NORMAL_STATE;
-			}
-			else if (temperature > 50) {
-				state = EMERGENCY_STATE;
-				INTERNAL_EEPROM_writeByte(0x00, EMERGENCY_STATE);
-			}
-			break;
+	/* Benchmark builds only, see profile.h */
+	PROFILE_INIT();
+	PROFILE_IDLE_LOOP();
 
-		case EMERGENCY_STATE:
-			if (emergencyTIME >= 14) {
-				state = ABNORMAL_STATE;
-				INTERNAL_EEPROM_writeByte(0x00, ABNORMAL_STATE);
-				UART_sendByte(ABNORMAL_CODE);
-				break;
-			} else if (temperature < 50) {
-				state = NORMAL_STATE;
-				INTERNAL_EEPROM_writeByte(0x00, NORMAL_STATE);
-			}
-			DcMotor_Rotate(CLOCKWISE, 100);
-			break;
-
-		case ABNORMAL_STATE:
-			emergencyTIME = 0;
-			DcMotor_Rotate(CLOCKWISE, 100);
-			WDT_ON(TIME_OUT_16MS); /* Enable Watchdog Timer */
-			break;
-
-		default:
-			break;
-		}
-
-		/* Handling button press for shutdown */
-		if (buttonPressed) {
-			if (temperature >= 40 && temperature <= 50) {
-				UART_sendByte(SHUTDOWN_CODE);
-			}
-			buttonPressed = 0; /* Reset button press flag */
-		}
-	}
+	Scheduler_start();
 }
-
-
-
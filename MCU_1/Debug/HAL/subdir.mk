@@ -5,18 +5,24 @@
 # Add inputs and outputs from these tool invocations to the build variables 
 C_SRCS += \
 ../HAL/button.c \
+../HAL/current_sensor.c \
 ../HAL/dc_motor.c \
-../HAL/lm35_sensor.c 
+../HAL/lm35_sensor.c \
+../HAL/tachometer.c 
 
 OBJS += \
 ./HAL/button.o \
+./HAL/current_sensor.o \
 ./HAL/dc_motor.o \
-./HAL/lm35_sensor.o 
+./HAL/lm35_sensor.o \
+./HAL/tachometer.o 
 
 C_DEPS += \
 ./HAL/button.d \
+./HAL/current_sensor.d \
 ./HAL/dc_motor.d \
-./HAL/lm35_sensor.d 
+./HAL/lm35_sensor.d \
+./HAL/tachometer.d 
 
 
 # Each subdirectory must supply rules for building sources it contributes
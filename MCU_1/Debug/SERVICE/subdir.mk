@@ -0,0 +1,48 @@
+################################################################################
+# Automatically-generated file. Do not edit!
+################################################################################
+
+# Add inputs and outputs from these tool invocations to the build variables 
+C_SRCS += \
+../SERVICE/band.c \
+../SERVICE/config.c \
+../SERVICE/event_log.c \
+../SERVICE/fan_curve.c \
+../SERVICE/link.c \
+../SERVICE/pid.c \
+../SERVICE/scheduler.c \
+../SERVICE/soft_timer.c \
+../SERVICE/timebase.c 
+
+OBJS += \
+./SERVICE/band.o \
+./SERVICE/config.o \
+./SERVICE/event_log.o \
+./SERVICE/fan_curve.o \
+./SERVICE/link.o \
+./SERVICE/pid.o \
+./SERVICE/scheduler.o \
+./SERVICE/soft_timer.o \
+./SERVICE/timebase.o 
+
+C_DEPS += \
+./SERVICE/band.d \
+./SERVICE/config.d \
+./SERVICE/event_log.d \
+./SERVICE/fan_curve.d \
+./SERVICE/link.d \
+./SERVICE/pid.d \
+./SERVICE/scheduler.d \
+./SERVICE/soft_timer.d \
+./SERVICE/timebase.d 
+
+
+# Each subdirectory must supply rules for building sources it contributes
+SERVICE/%.o: ../SERVICE/%.c SERVICE/subdir.mk
+	@echo 'Building file: $<'
+	@echo 'Invoking: AVR Compiler'
+	avr-gcc -Wall -g2 -gstabs -O0 -fpack-struct -fshort-enums -ffunction-sections -fdata-sections -std=gnu99 -funsigned-char -funsigned-bitfields -mmcu=atmega32 -DF_CPU=1000000UL -MMD -MP -MF"$(@:%.o=%.d)" -MT"$@" -c -o "$@" "$<"
+	@echo 'Finished building: $<'
+	@echo ' '
+
+
@@ -22,4 +22,5 @@ SUBDIRS := \
 APP \
 HAL \
 MCAL \
+SERVICE \
 
@@ -13,7 +13,159 @@
 #include "button.h"
 #include "../MCAL/gpio.h"
 #include  "..\common_macros.h"
-#include <avr/io.h>
+#include "../SERVICE/soft_timer.h"
+#include "../SERVICE/timebase.h"
+#include <avr/io.h> /* To use the SREG register */
+#include <avr/interrupt.h> /* To use cli() */
+
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+
+typedef struct {
+	uint8 port;
+	uint8 pin;
+	uint8 pressedLevel;
+	uint16 longPressTime;
+	uint8 count;              /* Samples in a row that differ from the debounced level */
+	boolean pressed;          /* Debounced level */
+	boolean longPosted;       /* The long press of this press was posted */
+	uint32 pressTime;         /* Time in ms of the debounced press */
+} Button_StateType;
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+static Button_StateType g_buttons[EXTI_NUM_OF_LINES];
+
+/* One bit per line, set by the external interrupt while the button is sampled */
+static volatile uint8 g_buttonActive = 0;
+
+static uint8 g_sampleTimer = SOFT_TIMER_INVALID;
+
+/* Posted by the sampling and taken by the application, both in thread context */
+static Button_EventType g_events[BUTTON_EVENT_QUEUE_SIZE];
+static uint8 g_eventHead = 0;
+static uint8 g_eventCount = 0;
+
+/*******************************************************************************
+ *                      Private Functions Definitions                          *
+ *******************************************************************************/
+
+/* Stops the interrupt of the line, which would fire on every bounce, and starts sampling it */
+static void BUTTON_wake(EXTI_LineType line)
+{
+	uint8 sreg;
+
+	EXTI_disable(line);
+
+	sreg = SREG;
+	cli();
+	g_buttonActive |= (1 << line);
+	SREG = sreg;
+}
+
+static void BUTTON_wakeInt0(void)
+{
+	BUTTON_wake(EXTI_INT0);
+}
+
+static void BUTTON_wakeInt1(void)
+{
+	BUTTON_wake(EXTI_INT1);
+}
+
+static void BUTTON_wakeInt2(void)
+{
+	BUTTON_wake(EXTI_INT2);
+}
+
+static void BUTTON_post(EXTI_LineType line, Button_EventKindType kind)
+{
+	uint8 tail;
+
+	if (g_eventCount >= BUTTON_EVENT_QUEUE_SIZE)
+	{
+		return;
+	}
+
+	tail = (g_eventHead + g_eventCount) % BUTTON_EVENT_QUEUE_SIZE;
+	g_events[tail].line = line;
+	g_events[tail].kind = kind;
+	g_eventCount++;
+}
+
+/*
+ * Sampling timer callback, runs the debouncing of the buttons in use. Once a
+ * button is released and stable its interrupt is enabled again, then the pin
+ * is read once more: a press that came before the enable left no flag.
+ */
+static void BUTTON_sample(void)
+{
+	uint8 line;
+	uint8 sreg;
+	boolean pressed;
+	Button_StateType *button;
+
+	for (line = 0; line < EXTI_NUM_OF_LINES; line++)
+	{
+		if (!(g_buttonActive & (1 << line)))
+		{
+			continue;
+		}
+
+		button = &g_buttons[line];
+		pressed = (GPIO_readPin(button->port, button->pin) == button->pressedLevel);
+
+		if (pressed != button->pressed)
+		{
+			button->count++;
+			if (button->count >= BUTTON_DEBOUNCE_SAMPLES)
+			{
+				button->pressed = pressed;
+				button->count = 0;
+				if (pressed)
+				{
+					button->pressTime = Time_nowMs();
+					button->longPosted = FALSE;
+					BUTTON_post(line, BUTTON_PRESS);
+				}
+				else
+				{
+					BUTTON_post(line, BUTTON_RELEASE);
+				}
+			}
+		}
+		else
+		{
+			button->count = 0;
+		}
+
+		if (button->pressed)
+		{
+			if (!button->longPosted && button->longPressTime != 0 &&
+					TIME_ELAPSED(Time_nowMs(), button->pressTime) >= button->longPressTime)
+			{
+				button->longPosted = TRUE;
+				BUTTON_post(line, BUTTON_LONG_PRESS);
+			}
+		}
+		else if (button->count == 0)
+		{
+			sreg = SREG;
+			cli();
+			g_buttonActive &= ~(1 << line);
+			SREG = sreg;
+
+			EXTI_enable(line);
+			if (GPIO_readPin(button->port, button->pin) == button->pressedLevel)
+			{
+				BUTTON_wake(line);
+			}
+		}
+	}
+}
 
 /*******************************************************************************
  *                      Functions Definitions                                  *
@@ -30,12 +182,58 @@
  * Return value: None
  * Description: Initializes the specified button's pin as an input pin.
  *              The configuration is based on the provided Button_ConfigType structure,
- *              which includes the port number and pin number.
+ *              which includes the port number and pin number. The external
+ *              interrupt of the pin is set on the edge of a press and only
+ *              wakes the sampling, the debouncing itself runs on the sampling
+ *              timer in thread context.
  *******************************************************************************/
 void BUTTON_init(const Button_ConfigType* Config_Ptr) {
+	EXTI_ConfigType exti_config;
+	Button_StateType *button;
+
+	if (Config_Ptr->line >= EXTI_NUM_OF_LINES) {
+		return;
+	}
+
 	/* Set up the pin as an input pin using the provided configuration */
 	GPIO_setupPinDirection(Config_Ptr->portNum, Config_Ptr->pinNum, PIN_INPUT);
 
+	button = &g_buttons[Config_Ptr->line];
+	button->port = Config_Ptr->portNum;
+	button->pin = Config_Ptr->pinNum;
+	button->pressedLevel = Config_Ptr->pressedLevel;
+	button->longPressTime = Config_Ptr->longPressTime;
+	button->count = 0;
+	button->pressed = FALSE;
+	button->longPosted = FALSE;
+
+	if (g_sampleTimer == SOFT_TIMER_INVALID) {
+		g_sampleTimer = SoftTimer_create(BUTTON_sample);
+		SoftTimer_start(g_sampleTimer, BUTTON_SAMPLE_PERIOD, BUTTON_SAMPLE_PERIOD);
+	}
+
+	switch (Config_Ptr->line) {
+	case EXTI_INT0:
+		EXTI_setCallBack(EXTI_INT0, BUTTON_wakeInt0);
+		break;
+	case EXTI_INT1:
+		EXTI_setCallBack(EXTI_INT1, BUTTON_wakeInt1);
+		break;
+	default:
+		EXTI_setCallBack(EXTI_INT2, BUTTON_wakeInt2);
+		break;
+	}
+
+	/* A button to ground idles high on the pull-up and falls when pressed */
+	exti_config.line = Config_Ptr->line;
+	exti_config.pullUp = (Config_Ptr->pressedLevel == LOGIC_LOW);
+	exti_config.sense = exti_config.pullUp ? EXTI_FALLING_EDGE : EXTI_RISING_EDGE;
+	EXTI_init(&exti_config);
+
+	/* Already held at start-up, no edge will come */
+	if (GPIO_readPin(button->port, button->pin) == button->pressedLevel) {
+		BUTTON_wake(Config_Ptr->line);
+	}
 }
 
 /******************************************************************************
@@ -56,4 +254,25 @@ uint8 BUTTON_getStates(uint8 PortNum, uint8 PinNum) {
 	return state;
 }
 
+/******************************************************************************
+ * Service Name: BUTTON_getEvent
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-reentrant
+ * Parameters (in): None
+ * Parameters (inout): None
+ * Parameters (out): event - The oldest event, if any
+ * Return value: boolean - TRUE if an event was taken
+ * Description: The events are posted by the sampling timer callback, which
+ *              runs in thread context like the callers, so the queue needs no
+ *              protection from the interrupts.
+ *******************************************************************************/
+boolean BUTTON_getEvent(Button_EventType *event) {
+	if (g_eventCount == 0) {
+		return FALSE;
+	}
 
+	*event = g_events[g_eventHead];
+	g_eventHead = (g_eventHead + 1) % BUTTON_EVENT_QUEUE_SIZE;
+	g_eventCount--;
+	return TRUE;
+}
@@ -4,7 +4,8 @@
  *
  * File Name: button.h
  *
- * Description: Header file for the Button driver
+ * Description: Header file for the Button driver, debounced buttons on the
+ *              external interrupt pins
  *
  * Author: Mohamed Hisham
  *
@@ -14,6 +15,7 @@
 #define BUTTON_H_
 
 #include "..\std_types.h"
+#include "../MCAL/exti.h"
 
 /*******************************************************************************
  *                                Definitions                                  *
@@ -25,7 +27,22 @@
 
 #define INT0_PIN_NUM	PIN2_ID
 #define INT1_PIN_NUM	PIN3_ID
-#define INT2_PIN_NUM	PIN2_ID
+#define INT2_PIN_NUM	PIN2_ID	/* The fan motor's IN2, EXTI_init rejects INT2 on this board */
+
+/*
+ * The pins are sampled on a periodic software timer, one tick of the time
+ * base, while a button is in use. A new level is taken once it was read on
+ * BUTTON_DEBOUNCE_SAMPLES samples in a row, about 25ms. The timer runs all
+ * the time, it is started in thread context and the presses come from the
+ * interrupts. Between two uses a button is not sampled, its tick only checks
+ * that no line is active, and the external interrupt of the pin waits for the
+ * next press.
+ */
+#define BUTTON_SAMPLE_PERIOD		8
+#define BUTTON_DEBOUNCE_SAMPLES		3
+
+/* Events not taken by the application yet, the newest ones are dropped when it is full */
+#define BUTTON_EVENT_QUEUE_SIZE		4
 
 /*******************************************************************************
  *                               Types Declaration                             *
@@ -34,8 +51,22 @@
 typedef struct {
 	uint8 pinNum;
 	uint8 portNum;
+	EXTI_LineType line;       /* External interrupt of the pin, a single button per line */
+	uint8 pressedLevel;       /* LOGIC_LOW for a button to ground, the pull-up is then enabled */
+	uint16 longPressTime;     /* ms held before BUTTON_LONG_PRESS, 0 for none */
 } Button_ConfigType;
 
+typedef enum {
+	BUTTON_PRESS,             /* Pressed, after the debouncing */
+	BUTTON_RELEASE,           /* Released, after the debouncing */
+	BUTTON_LONG_PRESS         /* Held for the long press time, the release still follows */
+} Button_EventKindType;
+
+typedef struct {
+	EXTI_LineType line;       /* The button is known by its line */
+	Button_EventKindType kind;
+} Button_EventType;
+
 /*******************************************************************************
  *                              Functions Prototypes                           *
  *******************************************************************************/
@@ -51,7 +82,9 @@ typedef struct {
  * Parameters (out): None
  * Return value: None
  * Description: Initializes the specified button's pin as an input pin,
- *              based on the provided configuration structure.
+ *              based on the provided configuration structure, and starts
+ *              watching its external interrupt. Creates the sampling timer
+ *              for the first button, so it is called after Scheduler_init.
  *******************************************************************************/
 void BUTTON_init(const Button_ConfigType* Config_Ptr);
 
@@ -69,6 +102,18 @@ void BUTTON_init(const Button_ConfigType* Config_Ptr);
  *******************************************************************************/
 uint8 BUTTON_getStates(uint8 PortNum, uint8 PinNum);
 
+/******************************************************************************
+ * Service Name: BUTTON_getEvent
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-reentrant
+ * Parameters (in): None
+ * Parameters (inout): None
+ * Parameters (out): event - The oldest event, if any
+ * Return value: boolean - TRUE if an event was taken
+ * Description: Takes the oldest press, release or long press event of the
+ *              buttons, never waits.
+ *******************************************************************************/
+boolean BUTTON_getEvent(Button_EventType *event);
 
 
 #endif /* BUTTON_H_ */
@@ -0,0 +1,218 @@
+ /******************************************************************************
+ *
+ * Module: Current Sensor
+ *
+ * File Name: current_sensor.c
+ *
+ * Description: Source file for the motor current sensor
+ *
+ * Author: Mohamed Hisham
+ *
+ *******************************************************************************/
+
+#include "current_sensor.h"
+#include "current_sensor_isr.h"
+#include "../MCAL/gpio.h"
+#include "../MCAL/isr_config.h"
+#include "../SERVICE/timebase.h"
+#include <avr/io.h>
+#include <avr/interrupt.h>
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+/* Written by Current_sample in current_sensor_isr.h */
+volatile uint16 g_currentSum = 0;
+volatile uint8 g_currentSamples = 0;
+uint16 g_currentTripLevel = ADC_MAXIMUM_VALUE + 1;
+
+static DcMotor_IdType g_motor = 0;
+static uint16 g_stallLevel = 0;        /* Stall current in ADC counts */
+static uint16 g_stallTime = 0;
+static uint16 g_filtered = 0;          /* Filtered current in ADC counts */
+static boolean g_aboveStall = FALSE;   /* TRUE while the filtered current is above the stall level */
+static uint32 g_aboveStallTime = 0;    /* Time in ms the filtered current went above the stall level */
+static volatile Current_FaultType g_fault = CURRENT_NO_FAULT;
+static volatile uint16 g_faultCurrent = 0; /* mA */
+
+/* Worst case of the conversions, the preprocessor works wider than 32 bits */
+#if ((65535ULL * CURRENT_SENSE_MV_PER_A) > 0xFFFFFFFFULL) || \
+	(((65535ULL * CURRENT_SENSE_MV_PER_A / 1000) * (ADC_MAXIMUM_VALUE + 1)) > 0xFFFFFFFFULL)
+#error "CURRENT_MA_TO_COUNTS overflows 32 bits"
+#endif
+#if ((65535ULL * ADC_REF_VOLT_VALUE * 1000) > 0xFFFFFFFFULL) || \
+	(((65535ULL * ADC_REF_VOLT_VALUE * 1000 / (ADC_MAXIMUM_VALUE + 1)) * 1000) > 0xFFFFFFFFULL)
+#error "CURRENT_COUNTS_TO_MA overflows 32 bits"
+#endif
+#if ((ADC_MAXIMUM_VALUE * ADC_REF_VOLT_VALUE * 1000ULL / (ADC_MAXIMUM_VALUE + 1)) * 1000 / CURRENT_SENSE_MV_PER_A) > 65535
+#error "The full scale current does not fit 16 bits"
+#endif
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * Called from Current_sample in the ADC interrupt. The motor is inhibited, it
+ * stays off whatever the application asks until the fault is cleared.
+ */
+void Current_trip(uint16 sample)
+{
+	DcMotor_setInhibit(g_motor, TRUE);
+
+	if (g_fault != CURRENT_OVERCURRENT)
+	{
+		g_fault = CURRENT_OVERCURRENT;
+		g_faultCurrent = CURRENT_COUNTS_TO_MA(sample);
+	}
+}
+
+/******************************************************************************
+ * Service Name: Current_init
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-reentrant
+ * Parameters (in): Config_Ptr - The motor and the fault levels
+ * Parameters (inout): None
+ * Parameters (out): None
+ * Return value: None
+ * Description: The samples are handled by Current_sample, through the ADC
+ *              callback unless it is bound to the vector in isr_config.h.
+ *              The Timer0 overflow triggers the conversions, so the sample is
+ *              taken at the same point of every PWM period.
+ *******************************************************************************/
+void Current_init(const Current_ConfigType *Config_Ptr)
+{
+	g_motor = Config_Ptr->motor;
+	g_stallLevel = CURRENT_MA_TO_COUNTS(Config_Ptr->stallCurrent);
+	g_stallTime = Config_Ptr->stallTime;
+	g_currentTripLevel = CURRENT_MA_TO_COUNTS(Config_Ptr->tripCurrent);
+
+	GPIO_setupPinDirection(CURRENT_SENSE_PORT, CURRENT_SENSE_CHANNEL, PIN_INPUT);
+
+#ifndef ADC_HANDLER
+	ADC_setCallBack(Current_sample);
+#endif
+	ADC_startAutoTrigger(CURRENT_SENSE_CHANNEL, ADC_TRIGGER_TIMER0_OVERFLOW);
+}
+
+/******************************************************************************
+ * Service Name: Current_update
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-reentrant
+ * Parameters (in): None
+ * Parameters (inout): None
+ * Parameters (out): None
+ * Return value: None
+ * Description: The samples are on-time currents, a jammed rotor draws its
+ *              stall current whatever the duty. A window without samples had
+ *              the motor off and counts as 0. The filter takes a quarter of
+ *              each new window, so the start-up inrush does not look like a
+ *              stall.
+ *******************************************************************************/
+void Current_update(void)
+{
+	uint16 sum;
+	uint8 samples;
+	uint16 average = 0;
+	uint32 now = Time_nowMs();
+	uint8 sreg = SREG;
+
+	/* Take the accumulated samples and start a new window */
+	cli();
+	sum = g_currentSum;
+	samples = g_currentSamples;
+	g_currentSum = 0;
+	g_currentSamples = 0;
+	SREG = sreg;
+
+	if (samples != 0)
+	{
+		average = sum / samples;
+	}
+
+	g_filtered = (uint16)((((uint32)g_filtered * 3) + average + 2) >> 2);
+
+	if (g_filtered >= g_stallLevel)
+	{
+		if (!g_aboveStall)
+		{
+			g_aboveStall = TRUE;
+			g_aboveStallTime = now;
+		}
+		else if ((TIME_ELAPSED(now, g_aboveStallTime) >= g_stallTime) && (g_fault == CURRENT_NO_FAULT))
+		{
+			DcMotor_setInhibit(g_motor, TRUE);
+			g_fault = CURRENT_STALL;
+			g_faultCurrent = CURRENT_COUNTS_TO_MA(g_filtered);
+		}
+	}
+	else
+	{
+		g_aboveStall = FALSE;
+	}
+}
+
+/******************************************************************************
+ * Service Name: Current_getMa
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters (in): None
+ * Parameters (inout): None
+ * Parameters (out): None
+ * Return value: uint16 - Filtered on-time current in mA
+ * Description: Returns the current computed by the last Current_update.
+ *******************************************************************************/
+uint16 Current_getMa(void)
+{
+	return CURRENT_COUNTS_TO_MA(g_filtered);
+}
+
+/******************************************************************************
+ * Service Name: Current_getFault
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters (in): None
+ * Parameters (inout): None
+ * Parameters (out): current_ptr - Current in mA that raised the fault
+ * Return value: Current_FaultType - The fault latched since the last clear
+ * Description: The trip sample for an overcurrent, the filtered current for
+ *              a stall.
+ *******************************************************************************/
+Current_FaultType Current_getFault(uint16 *current_ptr)
+{
+	uint8 sreg = SREG;
+	Current_FaultType fault;
+
+	cli();
+	fault = g_fault;
+	*current_ptr = g_faultCurrent;
+	SREG = sreg;
+
+	return fault;
+}
+
+/******************************************************************************
+ * Service Name: Current_clearFault
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-reentrant
+ * Parameters (in): None
+ * Parameters (inout): None
+ * Parameters (out): None
+ * Return value: None
+ * Description: Clears the latched fault and the stall timer and lifts the
+ *              motor inhibit, the motor stays off until it is driven again.
+ *******************************************************************************/
+void Current_clearFault(void)
+{
+	uint8 sreg = SREG;
+
+	g_aboveStall = FALSE;
+	g_filtered = 0;
+
+	/* A trip in between would be lost with its inhibit */
+	cli();
+	g_fault = CURRENT_NO_FAULT;
+	DcMotor_setInhibit(g_motor, FALSE);
+	SREG = sreg;
+}
@@ -0,0 +1,131 @@
+ /******************************************************************************
+ *
+ * Module: Current Sensor
+ *
+ * File Name: current_sensor.h
+ *
+ * Description: Header file for the motor current sensor, protects the Timer0
+ *              motor against overcurrent and a jammed rotor
+ *
+ * Author: Mohamed Hisham
+ *
+ *******************************************************************************/
+
+#ifndef CURRENT_SENSOR_H_
+#define CURRENT_SENSOR_H_
+
+#include "..\std_types.h"
+#include "../MCAL/adc.h"
+#include "dc_motor.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* The shunt amplifier output is wired to ADC1 (PA1) */
+#define CURRENT_SENSE_PORT		PORTA_ID
+#define CURRENT_SENSE_CHANNEL	1
+
+/* 0.1 ohm low side shunt and a gain of 10 */
+#define CURRENT_SENSE_MV_PER_A	1000
+
+/*
+ * Conversions between mA and ADC counts, through mV so no product passes 32
+ * bits for any uint16 input. Checked in current_sensor.c.
+ */
+#define CURRENT_MA_TO_COUNTS(ma) \
+	((uint16)(((((uint32)(ma) * CURRENT_SENSE_MV_PER_A) / 1000UL) * (ADC_MAXIMUM_VALUE + 1)) / (ADC_REF_VOLT_VALUE * 1000UL)))
+#define CURRENT_COUNTS_TO_MA(counts) \
+	((uint16)(((((uint32)(counts) * ADC_REF_VOLT_VALUE * 1000UL) / (ADC_MAXIMUM_VALUE + 1)) * 1000UL) / CURRENT_SENSE_MV_PER_A))
+
+/* Samples added per update window, 64 full scale samples still fit 16 bits */
+#define CURRENT_MAX_SAMPLES		64
+
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+
+typedef enum {
+	CURRENT_NO_FAULT,
+	CURRENT_OVERCURRENT,      /* One sample reached the trip current, the motor was cut in the ADC interrupt */
+	CURRENT_STALL             /* The filtered current stayed above the stall current, the rotor is jammed */
+} Current_FaultType;
+
+typedef struct {
+	DcMotor_IdType motor;     /* The motor on the Timer0 PWM, its bridge current goes through the shunt */
+	uint16 tripCurrent;       /* mA, the motor is cut at once at or above it */
+	uint16 stallCurrent;      /* mA, the filtered current a jammed rotor draws */
+	uint16 stallTime;         /* ms the filtered current has to stay above stallCurrent */
+} Current_ConfigType;
+
+/*******************************************************************************
+ *                              Functions Prototypes                           *
+ *******************************************************************************/
+
+/******************************************************************************
+ * Service Name: Current_init
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-reentrant
+ * Parameters (in): Config_Ptr - The motor and the fault levels
+ * Parameters (inout): None
+ * Parameters (out): None
+ * Return value: None
+ * Description: Starts sampling the current on every Timer0 overflow, at the
+ *              start of the PWM on-time. To be called after DcMotor_Init and
+ *              ADC_init.
+ *******************************************************************************/
+void Current_init(const Current_ConfigType *Config_Ptr);
+
+/******************************************************************************
+ * Service Name: Current_update
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-reentrant
+ * Parameters (in): None
+ * Parameters (inout): None
+ * Parameters (out): None
+ * Return value: None
+ * Description: Averages the samples taken since the last call, filters the
+ *              average and detects a jammed rotor. Called periodically from a
+ *              task.
+ *******************************************************************************/
+void Current_update(void);
+
+/******************************************************************************
+ * Service Name: Current_getMa
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters (in): None
+ * Parameters (inout): None
+ * Parameters (out): None
+ * Return value: uint16 - Filtered on-time current in mA
+ * Description: Returns the current computed by the last Current_update.
+ *******************************************************************************/
+uint16 Current_getMa(void);
+
+/******************************************************************************
+ * Service Name: Current_getFault
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters (in): None
+ * Parameters (inout): None
+ * Parameters (out): current_ptr - Current in mA that raised the fault
+ * Return value: Current_FaultType - The fault latched since the last clear
+ * Description: Tells if the motor was cut for an overcurrent or is jammed.
+ *              The motor is inhibited in DcMotor while a fault is latched.
+ *******************************************************************************/
+Current_FaultType Current_getFault(uint16 *current_ptr);
+
+/******************************************************************************
+ * Service Name: Current_clearFault
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-reentrant
+ * Parameters (in): None
+ * Parameters (inout): None
+ * Parameters (out): None
+ * Return value: None
+ * Description: Clears the latched fault and lifts the motor inhibit, before
+ *              the motor is driven again.
+ *******************************************************************************/
+void Current_clearFault(void);
+
+#endif /* CURRENT_SENSOR_H_ */
@@ -0,0 +1,65 @@
+ /******************************************************************************
+ *
+ * Module: Current Sensor
+ *
+ * File Name: current_sensor_isr.h
+ *
+ * Description: Inline sample handler of the current sensor, bound to the ADC
+ *              conversion complete vector in isr_config.h
+ *
+ * Author: Mohamed Hisham
+ *
+ *******************************************************************************/
+
+#ifndef CURRENT_SENSOR_ISR_H_
+#define CURRENT_SENSOR_ISR_H_
+
+#include "current_sensor.h"
+#include <avr/io.h>
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+/* Owned by current_sensor.c */
+extern volatile uint16 g_currentSum;      /* Sum of the samples taken since the last update */
+extern volatile uint8 g_currentSamples;   /* Number of samples in g_currentSum */
+extern uint16 g_currentTripLevel;         /* Trip current in ADC counts */
+
+/*******************************************************************************
+ *                              Functions Prototypes                           *
+ *******************************************************************************/
+
+/* Cuts the motor and latches the fault, out of line as it is the rare path */
+void Current_trip(uint16 sample);
+
+/*******************************************************************************
+ *                              Functions Definitions                          *
+ *******************************************************************************/
+
+/*
+ * ADC conversion complete handler. The sample is held 2 ADC clocks (16us)
+ * after the Timer0 overflow, at the start of the on-time. Samples taken with
+ * the enable off are skipped, the bridge then carries no current.
+ */
+static inline __attribute__((always_inline)) void Current_sample(void)
+{
+	uint16 sample = ADC;
+
+	if ((TCCR0 & (1<<COM01)) == 0)
+	{
+		return;
+	}
+
+	if (sample >= g_currentTripLevel)
+	{
+		Current_trip(sample);
+	}
+	else if (g_currentSamples < CURRENT_MAX_SAMPLES)
+	{
+		g_currentSum += sample;
+		g_currentSamples++;
+	}
+}
+
+#endif /* CURRENT_SENSOR_ISR_H_ */
@@ -18,21 +18,66 @@
 /*******************************************************************************
  *                                Definitions                                  *
  *******************************************************************************/
-#define DC_MOTOR_INPUT_1_PORT	PORTB_ID
-#define DC_MOTOR_INPUT_2_PORT	PORTB_ID
-#define DC_MOTOR_ENABLE_1_PORT	PORTB_ID
-#define DC_MOTOR_INPUT_1_PIN	PIN1_ID
-#define DC_MOTOR_INPUT_2_PIN	PIN2_ID
-#define DC_MOTOR_ENABLE_1_PIN	PIN3_ID
+
+/* One motor per PWM output: OC0, OC2, OC1A and OC1B */
+#define DC_MOTOR_MAX_INSTANCES	4
+
+/* Duty cycles are given in permille, 1000 is full speed */
+#define DC_MOTOR_DUTY_MAX		1000
+
+/* Time in us both bridge inputs stay low with the enable off between two modes */
+#define DC_MOTOR_DEAD_TIME_US	10
+
+/* Calibration table entries, the duty for 0%, 10% ... 100% of the airflow */
+#define DC_MOTOR_CALIBRATION_POINTS	11
 
 /*******************************************************************************
  *                               Types Declaration                             *
  *******************************************************************************/
 
+/*
+ * Bridge modes (IN1, IN2, EN), the enable is the PWM output:
+ * COAST:   L, L, off   the bridge is open, the motor runs down freely.
+ * BRAKE:   L, L, on    both motor terminals are shorted to ground, fast stop.
+ * FORWARD: L, H, PWM
+ * REVERSE: H, L, PWM
+ */
 typedef enum{
-	STOP,CLOCKWISE,ANTI_CLOCKWISE
+	COAST,BRAKE,FORWARD,REVERSE
 }DcMotor_State;
 
+/* Handle of a motor, its index in the configuration table */
+typedef uint8 DcMotor_IdType;
+
+/*
+ * PWM output driving the enable pin.
+ * DC_MOTOR_PWM_TIMER0: 8-bit fast PWM on OC0 (PB3), about 490Hz.
+ * DC_MOTOR_PWM_TIMER2: 8-bit fast PWM on OC2 (PD7) from the time base timer,
+ * 122Hz. PD7 is the buzzer on MCU_2.
+ * DC_MOTOR_PWM_TIMER1_A/B: 16-bit phase correct PWM on OC1A (PD5) or OC1B (PD4)
+ * at the configured frequency, for fans that take a 25kHz PWM input. It takes
+ * Timer1 for itself, so it cannot be used with the tachometer (MCU_1) or the
+ * servo (MCU_2).
+ */
+typedef enum{
+	DC_MOTOR_PWM_TIMER0,DC_MOTOR_PWM_TIMER2,DC_MOTOR_PWM_TIMER1_A,DC_MOTOR_PWM_TIMER1_B
+}DcMotor_PwmType;
+
+/* One entry of the configuration table, the table is kept in flash (PROGMEM) */
+typedef struct{
+	uint8 input1Port;
+	uint8 input1Pin;
+	uint8 input2Port;
+	uint8 input2Pin;
+	DcMotor_PwmType pwm;
+	uint32 frequency;   /* PWM frequency in Hz, used by the Timer1 outputs only, the first one sets it for both */
+	uint16 rampStep;    /* Permille added each Timer0 PWM period (about 2ms), 0 applies changes at once */
+	uint16 minDuty;     /* Lowest duty that keeps the motor turning, permille, a non zero speed never goes below it */
+	uint16 kickDuty;    /* Duty given from standstill to break the static friction, permille */
+	uint8 kickTicks;    /* Timer0 PWM periods the kick lasts, 0 for no kick */
+	const uint16 *calibration; /* Duty for each DC_MOTOR_CALIBRATION_POINTS airflow, in flash, NULL_PTR for a linear motor */
+}DcMotor_ConfigType;
+
 
 /*******************************************************************************
  *                      Functions Prototypes                                   *
@@ -40,23 +85,81 @@ typedef enum{
 
 /*
  * Description:
- * 	 The Function responsible for setup the direction for the two motor pins through the GPIO driver.
- * 	 Stop at the DC-Motor at the beginning through the GPIO driver.
- * Inputs: None
+ * 	 The Function responsible for setup the direction for the two pins of every motor through the GPIO driver.
+ * 	 Stop every DC-Motor at the beginning through the GPIO driver.
+ * 	 Start each PWM timer used once, the speed changes only update its duty cycle.
+ * 	 The ramps need Timer0, so they only run when one motor uses DC_MOTOR_PWM_TIMER0.
+ * Inputs:
+ *	 Config_Ptr: The configuration table in flash, its index is the handle of the motor. It is kept by the driver.
+ *	 count: Number of motors in the table, up to DC_MOTOR_MAX_INSTANCES.
  * Return: None
  */
-void DcMotor_Init(void);
+void DcMotor_Init(const DcMotor_ConfigType *Config_Ptr, uint8 count);
 
 /*
  * Description:
- * 	 The function responsible for rotate the DC Motor CW/ or A-CW or stop the motor based on the state input state value.
- *	 Send the required duty cycle to the PWM driver based on the required speed value.
+ * 	 The function responsible for rotate the DC Motor forward or reverse, or stop it by coasting or braking.
+ *	 A new mode first turns the enable off and opens the bridge for DC_MOTOR_DEAD_TIME_US, so the two
+ *	 patterns never overlap. Forward and reverse then ramp up from 0 at the configured rate.
+ *	 In the same mode only the speed changes. Asking again for the same mode and speed returns before the
+ *	 calibration table is read, until DcMotor_setDuty, DcMotor_rampTo or the inhibit change the duty.
+ *	 The speed is compensated for the motor: it goes through the calibration table and is kept at or
+ *	 above minDuty, and a start from standstill holds kickDuty for kickTicks before the ramp.
  * Inputs:
- *	 state: The required DC Motor state, it should be CW or A-CW or stop. DcMotor_State data type should be declared as enum or uint8.
+ *	 motor: The handle of the motor.
+ *	 state: The required bridge mode: COAST, BRAKE, FORWARD or REVERSE.
  *	 speed: decimal value for the required motor speed, it should be from 0 → 100. For example, if the input is 50, The motor should rotate with 50% of its maximum speed.
+ *	        Not used by COAST and BRAKE, the brake always uses the full enable.
 • Return: None
 */
-void DcMotor_Rotate(DcMotor_State state,uint8 speed);
+void DcMotor_Rotate(DcMotor_IdType motor,DcMotor_State state,uint8 speed);
+
+/*
+ * Description:
+ * 	 Change only the duty cycle at once, with a finer step than DcMotor_Rotate, the direction pins are kept.
+ * 	 A running ramp is dropped, so this is also the override for emergencies.
+ * 	 The same duty cycle is used whichever PWM timer is selected.
+ * Inputs:
+ *	 motor: The handle of the motor.
+ *	 duty: The duty cycle in permille, from 0 to DC_MOTOR_DUTY_MAX.
+ * Return: None
+ */
+void DcMotor_setDuty(DcMotor_IdType motor,uint16 duty);
+
+/*
+ * Description:
+ * 	 Move the duty cycle towards a target by rampStep each Timer0 PWM period, from its overflow interrupt.
+ * 	 The interrupt is only enabled while a motor differs from its target.
+ * 	 Asking again for the target already set returns at once.
+ * 	 Without a Timer0 motor or with a rampStep of 0 the duty cycle is set at once.
+ * Inputs:
+ *	 motor: The handle of the motor.
+ *	 duty: The target duty cycle in permille, from 0 to DC_MOTOR_DUTY_MAX.
+ * Return: None
+ */
+void DcMotor_rampTo(DcMotor_IdType motor,uint16 duty);
+
+/*
+ * Description:
+ * 	 Inhibit a motor after a fault, or allow it to run again. While inhibited every duty cycle asked for is 0,
+ * 	 whichever function asks for it, so a motor cut from an interrupt cannot be restarted by a late call.
+ * 	 Setting the inhibit turns the enable off at once, the direction pins are kept.
+ * 	 The motor stays off when the inhibit is cleared, until it is driven again.
+ * Inputs:
+ *	 motor: The handle of the motor.
+ *	 inhibit: TRUE to inhibit the motor, FALSE to allow it to run.
+ * Return: None
+ */
+void DcMotor_setInhibit(DcMotor_IdType motor,boolean inhibit);
+
+/*
+ * Description:
+ * 	 Tell if the motor is inhibited.
+ * Inputs:
+ *	 motor: The handle of the motor.
+ * Return: TRUE while the motor is inhibited.
+ */
+boolean DcMotor_isInhibited(DcMotor_IdType motor);
 
 
 #endif /* DC_MOTOR_H_ */
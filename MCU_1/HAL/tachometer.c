@@ -0,0 +1,146 @@
+ /******************************************************************************
+ *
+ * Module: Tachometer
+ *
+ * File Name: tachometer.c
+ *
+ * Description: Source file for the fan tachometer driver
+ *
+ * Author: Mohamed Hisham
+ *
+ *******************************************************************************/
+
+#include "tachometer.h"
+#include "tachometer_isr.h"
+#include "../MCAL/gpio.h"
+#include "../MCAL/timer1.h"
+#include "../MCAL/isr_config.h"
+#include "../SERVICE/timebase.h"
+#include <avr/io.h>
+#include <avr/interrupt.h>
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+/* Written by Tacho_edge in tachometer_isr.h */
+volatile uint32 g_tachoPeriodSum = 0;
+volatile uint8 g_tachoEdges = 0;
+volatile uint16 g_tachoLastCapture = 0;
+volatile boolean g_tachoSynced = FALSE;
+
+static uint16 g_rpm = 0;
+static boolean g_stalled = TRUE;
+static uint32 g_lastEdgeTime = 0;  /* Time in ms of the last update that saw an edge */
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+/******************************************************************************
+ * Service Name: Tacho_init
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-reentrant
+ * Parameters (in): None
+ * Parameters (inout): None
+ * Parameters (out): None
+ * Return value: None
+ * Description: The tach output is open collector, the internal pull-up is
+ *              enough. The edges are handled by Tacho_edge, through the Timer1
+ *              callback unless it is bound to the vector in isr_config.h.
+ *******************************************************************************/
+void Tacho_init(void)
+{
+	Timer1_ConfigType timer_config;
+
+	GPIO_setupPinDirection(TACHO_PORT, TACHO_PIN, PIN_INPUT);
+	GPIO_writePin(TACHO_PORT, TACHO_PIN, LOGIC_HIGH);
+
+	g_lastEdgeTime = Time_nowMs();
+
+	timer_config.initial_value = 0;
+	timer_config.compare_value = 0;
+	timer_config.compare_b_value = 0;
+	timer_config.top_value = 0;
+	timer_config.prescaler = PRESCALER_8;
+	timer_config.mode = INPUT_CAPTURE_MODE;
+	timer_config.output_a = OUTPUT_DISCONNECTED;
+	timer_config.output_b = OUTPUT_DISCONNECTED;
+	timer_config.capture_edge = CAPTURE_FALLING_EDGE;
+
+#ifndef TIMER1_CAPT_HANDLER
+	Timer1_setCallBack(TIMER1_CAPTURE_EVENT, Tacho_edge);
+#endif
+	Timer1_init(&timer_config);
+}
+
+/******************************************************************************
+ * Service Name: Tacho_update
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-reentrant
+ * Parameters (in): None
+ * Parameters (inout): None
+ * Parameters (out): None
+ * Return value: None
+ * Description: Averages all the periods captured since the last call, so the
+ *              division is done here once instead of in the ISR for each edge.
+ *******************************************************************************/
+void Tacho_update(void)
+{
+	uint32 sum;
+	uint8 edges;
+	uint32 now = Time_nowMs();
+	uint8 sreg = SREG;
+
+	/* Take the accumulated periods and start a new window */
+	cli();
+	sum = g_tachoPeriodSum;
+	edges = g_tachoEdges;
+	g_tachoPeriodSum = 0;
+	g_tachoEdges = 0;
+	SREG = sreg;
+
+	if ((edges != 0) && (sum != 0))
+	{
+		g_rpm = (uint16)(((TACHO_RPM_FACTOR * edges) + (sum / 2)) / sum);
+		g_stalled = FALSE;
+		g_lastEdgeTime = now;
+	}
+	else if (TIME_ELAPSED(now, g_lastEdgeTime) > TACHO_STALL_TIMEOUT)
+	{
+		g_rpm = 0;
+		g_stalled = TRUE;
+		/* The next edge starts a new measurement */
+		g_tachoSynced = FALSE;
+	}
+}
+
+/******************************************************************************
+ * Service Name: Tacho_getRpm
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters (in): None
+ * Parameters (inout): None
+ * Parameters (out): None
+ * Return value: uint16 - Fan speed in RPM, 0 when stalled
+ * Description: Returns the fan speed computed by the last Tacho_update.
+ *******************************************************************************/
+uint16 Tacho_getRpm(void)
+{
+	return g_rpm;
+}
+
+/******************************************************************************
+ * Service Name: Tacho_isStalled
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters (in): None
+ * Parameters (inout): None
+ * Parameters (out): None
+ * Return value: boolean - TRUE if no tach edge came for TACHO_STALL_TIMEOUT
+ * Description: Tells if the fan is not turning.
+ *******************************************************************************/
+boolean Tacho_isStalled(void)
+{
+	return g_stalled;
+}
@@ -0,0 +1,95 @@
+ /******************************************************************************
+ *
+ * Module: Tachometer
+ *
+ * File Name: tachometer.h
+ *
+ * Description: Header file for the fan tachometer driver
+ *
+ * Author: Mohamed Hisham
+ *
+ *******************************************************************************/
+
+#ifndef TACHOMETER_H_
+#define TACHOMETER_H_
+
+#include "..\std_types.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* The tach output is wired to ICP1, it takes Timer1 for itself */
+#define TACHO_PORT				PORTD_ID
+#define TACHO_PIN				PIN6_ID
+
+/* Tach pulses per fan revolution, 2 for most PC style fans */
+#define TACHO_PULSES_PER_REV	2
+
+/* Timer1 runs at F_CPU/8, one count every 8us at 1MHz */
+#define TACHO_COUNT_US			8
+
+/* RPM = TACHO_RPM_FACTOR / period in counts */
+#define TACHO_RPM_FACTOR		(60000000UL / (TACHO_COUNT_US * TACHO_PULSES_PER_REV))
+
+/*
+ * The fan is stalled when no edge comes for this time in ms. It is shorter
+ * than the 524ms Timer1 wrap around, so a measured period is never wrapped.
+ */
+#define TACHO_STALL_TIMEOUT		500
+
+/*******************************************************************************
+ *                              Functions Prototypes                           *
+ *******************************************************************************/
+
+/******************************************************************************
+ * Service Name: Tacho_init
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-reentrant
+ * Parameters (in): None
+ * Parameters (inout): None
+ * Parameters (out): None
+ * Return value: None
+ * Description: Sets up the tach pin with its pull-up and starts Timer1 in input
+ *              capture mode on the falling edges.
+ *******************************************************************************/
+void Tacho_init(void);
+
+/******************************************************************************
+ * Service Name: Tacho_update
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-reentrant
+ * Parameters (in): None
+ * Parameters (inout): None
+ * Parameters (out): None
+ * Return value: None
+ * Description: Computes the fan speed from the periods captured since the last
+ *              call and detects a stall. Called periodically from a task.
+ *******************************************************************************/
+void Tacho_update(void);
+
+/******************************************************************************
+ * Service Name: Tacho_getRpm
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters (in): None
+ * Parameters (inout): None
+ * Parameters (out): None
+ * Return value: uint16 - Fan speed in RPM, 0 when stalled
+ * Description: Returns the fan speed computed by the last Tacho_update.
+ *******************************************************************************/
+uint16 Tacho_getRpm(void);
+
+/******************************************************************************
+ * Service Name: Tacho_isStalled
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters (in): None
+ * Parameters (inout): None
+ * Parameters (out): None
+ * Return value: boolean - TRUE if no tach edge came for TACHO_STALL_TIMEOUT
+ * Description: Tells if the fan is not turning.
+ *******************************************************************************/
+boolean Tacho_isStalled(void);
+
+#endif /* TACHOMETER_H_ */
@@ -0,0 +1,55 @@
+ /******************************************************************************
+ *
+ * Module: Tachometer
+ *
+ * File Name: tachometer_isr.h
+ *
+ * Description: Inline edge handler of the tachometer, bound to the Timer1
+ *              input capture vector in isr_config.h
+ *
+ * Author: Mohamed Hisham
+ *
+ *******************************************************************************/
+
+#ifndef TACHOMETER_ISR_H_
+#define TACHOMETER_ISR_H_
+
+#include "tachometer.h"
+#include <avr/io.h>
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+/* Owned by tachometer.c */
+extern volatile uint32 g_tachoPeriodSum;  /* Sum of the periods captured since the last update */
+extern volatile uint8 g_tachoEdges;       /* Number of periods in g_tachoPeriodSum */
+extern volatile uint16 g_tachoLastCapture;
+extern volatile boolean g_tachoSynced;    /* FALSE until the first edge after a stall */
+
+/*******************************************************************************
+ *                              Functions Definitions                          *
+ *******************************************************************************/
+
+/*
+ * Timer1 capture handler, only adds the period since the previous edge. The
+ * first edge after a stall only gives the reference point.
+ */
+static inline __attribute__((always_inline)) void Tacho_edge(void)
+{
+	uint16 capture = ICR1;
+
+	if (g_tachoSynced)
+	{
+		g_tachoPeriodSum += (uint16)(capture - g_tachoLastCapture);
+		g_tachoEdges++;
+	}
+	else
+	{
+		g_tachoSynced = TRUE;
+	}
+
+	g_tachoLastCapture = capture;
+}
+
+#endif /* TACHOMETER_ISR_H_ */
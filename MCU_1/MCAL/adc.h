@@ -21,6 +21,17 @@
 #define ADC_MAXIMUM_VALUE    1023
 #define ADC_REF_VOLT_VALUE   5
 
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+
+/* Auto trigger sources, the ADTS2:0 value in SFIOR */
+typedef enum
+{
+	ADC_TRIGGER_FREE_RUNNING,ADC_TRIGGER_ANALOG_COMPARATOR,ADC_TRIGGER_INT0,ADC_TRIGGER_TIMER0_COMPARE,
+	ADC_TRIGGER_TIMER0_OVERFLOW,ADC_TRIGGER_TIMER1_COMPARE_B,ADC_TRIGGER_TIMER1_OVERFLOW,ADC_TRIGGER_TIMER1_CAPTURE
+}ADC_TriggerType;
+
 /*******************************************************************************
  *                      Functions Prototypes                                   *
  *******************************************************************************/
@@ -38,4 +49,28 @@ void ADC_init(void);
  */
 uint16 ADC_readChannel(uint8 channel_num);
 
+/*
+ * Description :
+ * Function responsible for converting a channel on every event of the trigger
+ * source, the conversion complete interrupt gives each result to the callback
+ * (or to ADC_HANDLER of isr_config.h), which reads it from the ADC register.
+ * ADC_readChannel can still be used, it pauses the triggered conversions while
+ * it converts its own channel.
+ */
+void ADC_startAutoTrigger(uint8 channel_num, ADC_TriggerType trigger);
+
+/*
+ * Description :
+ * Function responsible for stopping the triggered conversions, a running
+ * conversion still completes.
+ */
+void ADC_stopAutoTrigger(void);
+
+/*
+ * Description :
+ * Function to set the Callback function address of the conversion complete
+ * interrupt. It has no effect when ADC_HANDLER is bound in isr_config.h.
+ */
+void ADC_setCallBack(void(*a_ptr)(void));
+
 #endif /* ADC_H_ */
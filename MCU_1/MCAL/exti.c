@@ -0,0 +1,191 @@
+ /******************************************************************************
+ *
+ * Module: EXTI
+ *
+ * File Name: exti.c
+ *
+ * Description: Source file for the AVR external interrupts INT0, INT1 and INT2
+ *
+ * Author: Mohamed Hisham
+ *
+ *******************************************************************************/
+
+#include "exti.h"
+#include "gpio.h"
+#include <avr/io.h> /* To use the external interrupt Registers */
+#include <avr/interrupt.h> /* For the external interrupt ISRs */
+#include "isr_config.h" /* For the handlers bound at compile time */
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+/* Global variables to hold the address of the callback function of each line */
+static void (*volatile g_callBackPtr[EXTI_NUM_OF_LINES])(void) = {NULL_PTR, NULL_PTR, NULL_PTR};
+
+/* Enable bit in GICR and flag bit in GIFR of each line, they are at the same positions */
+static const uint8 g_lineBit[EXTI_NUM_OF_LINES] = {(1<<INT0), (1<<INT1), (1<<INT2)};
+
+/*******************************************************************************
+ *                       Interrupt Service Routines                            *
+ *******************************************************************************/
+
+ISR(INT0_vect)
+{
+#ifdef INT0_HANDLER
+	/* Handler bound at compile time, inlined in the vector */
+	INT0_HANDLER();
+#else
+	if(g_callBackPtr[EXTI_INT0] != NULL_PTR)
+	{
+		/* Call the Callback function in the application after an edge on INT0 */
+		(*g_callBackPtr[EXTI_INT0])();
+	}
+#endif
+}
+
+ISR(INT1_vect)
+{
+#ifdef INT1_HANDLER
+	/* Handler bound at compile time, inlined in the vector */
+	INT1_HANDLER();
+#else
+	if(g_callBackPtr[EXTI_INT1] != NULL_PTR)
+	{
+		/* Call the Callback function in the application after an edge on INT1 */
+		(*g_callBackPtr[EXTI_INT1])();
+	}
+#endif
+}
+
+ISR(INT2_vect)
+{
+#ifdef INT2_HANDLER
+	/* Handler bound at compile time, inlined in the vector */
+	INT2_HANDLER();
+#else
+	if(g_callBackPtr[EXTI_INT2] != NULL_PTR)
+	{
+		/* Call the Callback function in the application after an edge on INT2 */
+		(*g_callBackPtr[EXTI_INT2])();
+	}
+#endif
+}
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+void EXTI_init(const EXTI_ConfigType * Config_Ptr)
+{
+	uint8 port_num;
+	uint8 pin_num;
+
+	/* Null pointer check */
+	if (Config_Ptr == NULL_PTR)
+	{
+		return;
+	}
+
+	switch(Config_Ptr->line)
+	{
+	case EXTI_INT0:
+		port_num = EXTI_INT0_PORT_ID;
+		pin_num = EXTI_INT0_PIN_ID;
+		break;
+	case EXTI_INT1:
+		port_num = EXTI_INT1_PORT_ID;
+		pin_num = EXTI_INT1_PIN_ID;
+		break;
+	case EXTI_INT2:
+		/* PB2 drives the fan motor */
+		if (!EXTI_INT2_PIN_FREE)
+		{
+			return;
+		}
+		/* INT2 is edge triggered only */
+		if ((Config_Ptr->sense != EXTI_FALLING_EDGE) && (Config_Ptr->sense != EXTI_RISING_EDGE))
+		{
+			return;
+		}
+		port_num = EXTI_INT2_PORT_ID;
+		pin_num = EXTI_INT2_PIN_ID;
+		break;
+	default:
+		return;
+	}
+
+	/* The line is disabled while its sense changes, the change may raise its flag */
+	EXTI_disable(Config_Ptr->line);
+
+	GPIO_setupPinDirection(port_num, pin_num, PIN_INPUT);
+	GPIO_writePin(port_num, pin_num, Config_Ptr->pullUp ? LOGIC_HIGH : LOGIC_LOW);
+
+	/* Only touch the sense bits of the line, MCUCR also holds the sleep mode */
+	switch(Config_Ptr->line)
+	{
+	case EXTI_INT0:
+		MCUCR = (MCUCR & ~((1<<ISC01) | (1<<ISC00))) | ((Config_Ptr->sense & 0x03) << ISC00);
+		break;
+	case EXTI_INT1:
+		MCUCR = (MCUCR & ~((1<<ISC11) | (1<<ISC10))) | ((Config_Ptr->sense & 0x03) << ISC10);
+		break;
+	default:
+		if (Config_Ptr->sense == EXTI_RISING_EDGE)
+		{
+			MCUCSR |= (1<<ISC2);
+		}
+		else
+		{
+			MCUCSR &= ~(1<<ISC2);
+		}
+		break;
+	}
+
+	EXTI_enable(Config_Ptr->line);
+}
+
+void EXTI_enable(EXTI_LineType line)
+{
+	uint8 sreg;
+
+	if ((line >= EXTI_NUM_OF_LINES) || ((line == EXTI_INT2) && !EXTI_INT2_PIN_FREE))
+	{
+		return;
+	}
+
+	/* The flag is cleared by writing one to it */
+	GIFR = g_lineBit[line];
+
+	/* GICR is shared by the lines, which may be changed from their interrupts */
+	sreg = SREG;
+	cli();
+	GICR |= g_lineBit[line];
+	SREG = sreg;
+}
+
+void EXTI_disable(EXTI_LineType line)
+{
+	uint8 sreg;
+
+	if (line >= EXTI_NUM_OF_LINES)
+	{
+		return;
+	}
+
+	sreg = SREG;
+	cli();
+	GICR &= ~g_lineBit[line];
+	SREG = sreg;
+}
+
+void EXTI_setCallBack(EXTI_LineType line, void(*a_ptr)(void))
+{
+	if (line >= EXTI_NUM_OF_LINES)
+	{
+		return;
+	}
+
+	/* Save the address of the Callback function in a global variable */
+	g_callBackPtr[line] = a_ptr;
+}
@@ -0,0 +1,101 @@
+ /******************************************************************************
+ *
+ * Module: EXTI
+ *
+ * File Name: exti.h
+ *
+ * Description: Header file for the AVR external interrupts INT0, INT1 and INT2
+ *
+ * Author: Mohamed Hisham
+ *
+ *******************************************************************************/
+
+#ifndef EXTI_H_
+#define EXTI_H_
+
+#include "..\std_types.h"
+#include "gpio.h" /* For the port and pin IDs */
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+#define EXTI_NUM_OF_LINES	3
+
+/* Pins of the lines */
+#define EXTI_INT0_PORT_ID	PORTD_ID
+#define EXTI_INT0_PIN_ID	PIN2_ID
+#define EXTI_INT1_PORT_ID	PORTD_ID
+#define EXTI_INT1_PIN_ID	PIN3_ID
+#define EXTI_INT2_PORT_ID	PORTB_ID
+#define EXTI_INT2_PIN_ID	PIN2_ID
+
+/*
+ * PB2 is IN2 of the fan motor bridge on this board, INT2 would make it an
+ * input and take interrupts on the motor direction. INT2 is rejected unless
+ * this is set to TRUE, on a board where PB2 is free.
+ */
+#define EXTI_INT2_PIN_FREE	FALSE
+
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+
+typedef enum{
+	EXTI_INT0, EXTI_INT1, EXTI_INT2
+} EXTI_LineType;
+
+/* Same order as the ISCx1:ISCx0 bits, INT2 only has the falling and rising edges */
+typedef enum{
+	EXTI_LOW_LEVEL, EXTI_ANY_EDGE, EXTI_FALLING_EDGE, EXTI_RISING_EDGE
+} EXTI_SenseType;
+
+typedef struct {
+	EXTI_LineType line;
+	EXTI_SenseType sense;
+	boolean pullUp; // Enables the internal pull-up of the pin.
+} EXTI_ConfigType;
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+
+/*
+ * Description:
+ * Function to set the line pin as input, with or without its pull-up, set the
+ * sense and enable the line. A flag left by an earlier edge is cleared first.
+ * If the line or the sense is not correct, or the line is INT2 while its pin is
+ * not free (EXTI_INT2_PIN_FREE), The function will not handle the request.
+ * Inputs: pointer to the configuration structure with type EXTI_ConfigType.
+ * Return: None
+ */
+void EXTI_init(const EXTI_ConfigType * Config_Ptr);
+
+/*
+ * Description:
+ * Function to enable the line, a flag left by an edge while it was disabled
+ * is cleared first so no old edge is reported. INT2 is not enabled while its
+ * pin is not free.
+ * Inputs: the line.
+ * Return: None
+ */
+void EXTI_enable(EXTI_LineType line);
+
+/*
+ * Description:
+ * Function to disable the line, its edges are still latched in the flag.
+ * Inputs: the line.
+ * Return: None
+ */
+void EXTI_disable(EXTI_LineType line);
+
+/*
+ * Description:
+ * Function to set the Callback function of a line, called from its interrupt.
+ * It has no effect on the dispatch of a vector bound in isr_config.h.
+ * Inputs: the line and a pointer to the Callback function.
+ * Return: None
+ */
+void EXTI_setCallBack(EXTI_LineType line, void(*a_ptr)(void));
+
+#endif /* EXTI_H_ */
@@ -13,6 +13,7 @@
 #include "gpio.h"
 #include "..\common_macros.h" /* To use the macros like SET_BIT */
 #include "avr/io.h" /* To use the IO Ports Registers */
+#include <avr/interrupt.h> /* To use cli() */
 #include "..\std_types.h"
 
 /*
@@ -279,6 +280,45 @@ void GPIO_writePort(uint8 port_num, uint8 value)
 
 }
 
+/*
+ * Description :
+ * Write the value on the pins of the mask in the required port, the other pins keep their value.
+ * All the pins of the mask change together in a single write of the port.
+ * If the input port number is not correct, The function will not handle the request.
+ * Interrupts also write pins, so the read-modify-write is done with the interrupts off.
+ */
+void GPIO_writeMasked(uint8 port_num, uint8 mask, uint8 value)
+{
+	uint8 sreg;
+
+	if(port_num >= NUM_OF_PORTS)
+	{
+		/* Do Nothing */
+	}
+	else
+	{
+		value &= mask;
+		sreg = SREG;
+		cli();
+		switch(port_num)
+		{
+		case PORTA_ID:
+			PORTA = (PORTA & ~mask) | value;
+			break;
+		case PORTB_ID:
+			PORTB = (PORTB & ~mask) | value;
+			break;
+		case PORTC_ID:
+			PORTC = (PORTC & ~mask) | value;
+			break;
+		case PORTD_ID:
+			PORTD = (PORTD & ~mask) | value;
+			break;
+		}
+		SREG = sreg;
+	}
+}
+
 /*
  * Description :
  * Read and return the value of the required port.
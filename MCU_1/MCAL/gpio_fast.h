@@ -0,0 +1,63 @@
+ /******************************************************************************
+ *
+ * Module: GPIO
+ *
+ * File Name: gpio_fast.h
+ *
+ * Description: Compile time pin access for the AVR GPIO driver, header only
+ *
+ * Author: Mohamed Hisham
+ *
+ *******************************************************************************/
+
+#ifndef GPIO_FAST_H_
+#define GPIO_FAST_H_
+
+#include "gpio.h"
+#include <avr/io.h> /* To use the IO Ports Registers */
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * For pins known at compile time (PORTx_ID and PINx_ID constants). Each
+ * access is one sbi, cbi or in instruction, even at -O0, with no call, no
+ * switch and no run time bounds check: a port or pin out of range fails to
+ * compile instead, on a negative array size.
+ * sbi and cbi cannot be cut by an interrupt, so no critical section is
+ * needed either. Pins taken from a table at run time keep using the GPIO
+ * functions of gpio.h.
+ */
+
+/* The ID itself, or a compile error when it is out of range. Still a constant expression */
+#define GPIO_CHECK_PORT_ID(port_id)	((port_id) + (0 * sizeof(char[((port_id) < NUM_OF_PORTS) ? 1 : -1])))
+#define GPIO_CHECK_PIN_ID(pin_id)	((pin_id) + (0 * sizeof(char[((pin_id) < NUM_OF_PINS_PER_PORT) ? 1 : -1])))
+
+/*
+ * I/O addresses of the port registers, each port is 3 addresses below the
+ * previous one. Past PORTD_ID they would be other registers (SPCR, UCSRB ...).
+ */
+#define GPIO_PIN_IO_ADDR(port_id)		(_SFR_IO_ADDR(PINA) - (3 * GPIO_CHECK_PORT_ID(port_id)))
+#define GPIO_DDR_IO_ADDR(port_id)		(_SFR_IO_ADDR(DDRA) - (3 * GPIO_CHECK_PORT_ID(port_id)))
+#define GPIO_PORT_IO_ADDR(port_id)		(_SFR_IO_ADDR(PORTA) - (3 * GPIO_CHECK_PORT_ID(port_id)))
+
+#define GPIO_SBI(io_addr, pin_id) \
+	__asm__ __volatile__ ("sbi %0, %1" : : "I" (io_addr), "I" (GPIO_CHECK_PIN_ID(pin_id)))
+#define GPIO_CBI(io_addr, pin_id) \
+	__asm__ __volatile__ ("cbi %0, %1" : : "I" (io_addr), "I" (GPIO_CHECK_PIN_ID(pin_id)))
+
+/* Direction of a pin */
+#define GPIO_FAST_SETUP_OUTPUT(port_id, pin_id)		GPIO_SBI(GPIO_DDR_IO_ADDR(port_id), pin_id)
+#define GPIO_FAST_SETUP_INPUT(port_id, pin_id)		GPIO_CBI(GPIO_DDR_IO_ADDR(port_id), pin_id)
+
+/* Output level of a pin, or the pull-up of an input pin */
+#define GPIO_FAST_SET(port_id, pin_id)				GPIO_SBI(GPIO_PORT_IO_ADDR(port_id), pin_id)
+#define GPIO_FAST_CLEAR(port_id, pin_id)			GPIO_CBI(GPIO_PORT_IO_ADDR(port_id), pin_id)
+#define GPIO_FAST_WRITE(port_id, pin_id, value) \
+	do { if (value) { GPIO_FAST_SET(port_id, pin_id); } else { GPIO_FAST_CLEAR(port_id, pin_id); } } while (0)
+
+/* Level of a pin, LOGIC_HIGH or LOGIC_LOW */
+#define GPIO_FAST_READ(port_id, pin_id)	((_SFR_IO8(GPIO_PIN_IO_ADDR(port_id)) >> GPIO_CHECK_PIN_ID(pin_id)) & 1)
+
+#endif /* GPIO_FAST_H_ */
@@ -13,8 +13,57 @@
 #include "internal_EEPROM.h"
 #include "..\common_macros.h"
 #include "avr/io.h"
+#include <avr/interrupt.h>
 #include <avr/delay.h>
 
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+
+typedef struct {
+	uint16 address;
+	uint8 data;
+} INTERNAL_EEPROM_WriteRequest;
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+/* Circular queue of bytes waiting to be programmed by the EEPROM ready ISR */
+static volatile INTERNAL_EEPROM_WriteRequest g_writeQueue[INTERNAL_EEPROM_WRITE_QUEUE_SIZE];
+static volatile uint8 g_writeHead = 0;
+static volatile uint8 g_writeTail = 0;
+static volatile uint8 g_writeCount = 0;
+
+/*******************************************************************************
+ *                       Interrupt Service Routines                            *
+ *******************************************************************************/
+
+/*
+ * The EEPROM ready interrupt fires continuously while EEWE is cleared and EERIE
+ * is set, so every entry starts the next queued write and the interrupt disables
+ * itself once the queue is empty.
+ */
+ISR(EE_RDY_vect)
+{
+	if (g_writeCount == 0)
+	{
+		CLEAR_BIT(EECR,EERIE);
+		return;
+	}
+
+	EEARL = g_writeQueue[g_writeTail].address;
+	EEARH = (g_writeQueue[g_writeTail].address >> 8);
+	EEDR = g_writeQueue[g_writeTail].data;
+
+	/* Interrupts are already disabled here, so EEWE follows EEMWE within four cycles */
+	asm("SBI 0x1C,2");
+	asm("SBI 0x1C,1");
+
+	g_writeTail = (g_writeTail + 1) % INTERNAL_EEPROM_WRITE_QUEUE_SIZE;
+	g_writeCount--;
+}
+
 /*******************************************************************************
  *                      Functions Definitions                                  *
  *******************************************************************************/
@@ -36,8 +85,21 @@
  *              to trigger the EEPROM write operation, ensuring precise control over the number of clocks.
  *******************************************************************************/
 void INTERNAL_EEPROM_writeByte(uint16 Address, uint8 Data) {
-	/* Wait for the completion of any previous write operation */
-	while(EECR & (1<<EEWE));
+	uint8 sreg;
+
+	/*
+	 * Wait for the completion of any previous write operation, then keep the
+	 * interrupts (and so the queued writes) off until this write is started
+	 */
+	do {
+		sreg = SREG;
+		cli();
+		if (BIT_IS_CLEAR(EECR,EEWE))
+		{
+			break;
+		}
+		SREG = sreg;
+	} while(1);
 
 	/* Set up the address registers */
 	EEARL = Address;
@@ -52,6 +114,8 @@ void INTERNAL_EEPROM_writeByte(uint16 Address, uint8 Data) {
 	 /* Trigger the write operation by setting the EEWE bit using assembly instruction */
 	asm("SBI 0x1C,1");
 
+	/* Restore the interrupts state */
+	SREG = sreg;
 }
 
 /******************************************************************************
@@ -68,12 +132,26 @@ void INTERNAL_EEPROM_writeByte(uint16 Address, uint8 Data) {
  *              EEPROM read operation.
  *******************************************************************************/
 uint8 INTERNAL_EEPROM_readByte(uint16 Address) {
-	/* Wait for the completion of any previous write operation */
-	while(EECR & (1<<EEWE));
+	uint8 sreg;
+	uint8 data;
 
 	/* Wait until the Self-Programming Mode (SPM) is ready */
 	while(SPMCR & (1<<SPMEN));
 
+	/*
+	 * Wait for the completion of any previous write operation, then keep the
+	 * EEPROM ready ISR from changing the address registers during the read
+	 */
+	do {
+		sreg = SREG;
+		cli();
+		if (BIT_IS_CLEAR(EECR,EEWE))
+		{
+			break;
+		}
+		SREG = sreg;
+	} while(1);
+
 	/* Set up the address registers */
 	EEARL = Address;
 	EEARH = (Address >> 8);
@@ -81,6 +159,94 @@ uint8 INTERNAL_EEPROM_readByte(uint16 Address) {
 	/* Start the EEPROM read by setting the EERE bit */
 	SET_BIT(EECR,EERE);
 
-	 /* Return the data from the data register */
-	return EEDR;
+	/* Read the data from the data register */
+	data = EEDR;
+
+	/* Restore the interrupts state */
+	SREG = sreg;
+
+	return data;
+}
+
+/******************************************************************************
+ * Service Name: INTERNAL_EEPROM_writeBlockAsync
+ * Sync/Async: Asynchronous
+ * Reentrancy: Reentrant
+ * Parameters (in): Address - The first EEPROM address of the block
+ *                  Data_Ptr - Pointer to the bytes to be written
+ *                  Size - Number of bytes to write
+ * Parameters (inout): None
+ * Parameters (out): None
+ * Return value: boolean - TRUE if the whole block was queued, FALSE if the
+ *                         queue has no room for it (nothing is queued)
+ * Description: Copies the block into the write queue with interrupts disabled
+ *              and enables the EEPROM ready interrupt which drains the queue.
+ *******************************************************************************/
+boolean INTERNAL_EEPROM_writeBlockAsync(uint16 Address, const uint8 *Data_Ptr, uint8 Size) {
+	uint8 sreg;
+	uint8 i;
+
+	if (Data_Ptr == NULL_PTR)
+	{
+		return FALSE;
+	}
+
+	sreg = SREG;
+	cli();
+
+	if ((INTERNAL_EEPROM_WRITE_QUEUE_SIZE - g_writeCount) < Size)
+	{
+		SREG = sreg;
+		return FALSE;
+	}
+
+	for (i = 0; i < Size; i++)
+	{
+		g_writeQueue[g_writeHead].address = Address + i;
+		g_writeQueue[g_writeHead].data = Data_Ptr[i];
+		g_writeHead = (g_writeHead + 1) % INTERNAL_EEPROM_WRITE_QUEUE_SIZE;
+	}
+	g_writeCount += Size;
+
+	/* Let the EEPROM ready ISR start the writes */
+	SET_BIT(EECR,EERIE);
+
+	SREG = sreg;
+
+	return TRUE;
+}
+
+/******************************************************************************
+ * Service Name: INTERNAL_EEPROM_readBlock
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-reentrant
+ * Parameters (in): Address - The first EEPROM address of the block
+ *                  Size - Number of bytes to read
+ * Parameters (inout): None
+ * Parameters (out): Data_Ptr - Buffer that receives the bytes
+ * Return value: None
+ * Description: Reads a block of consecutive bytes from the internal EEPROM.
+ *******************************************************************************/
+void INTERNAL_EEPROM_readBlock(uint16 Address, uint8 *Data_Ptr, uint8 Size) {
+	uint8 i;
+
+	for (i = 0; i < Size; i++)
+	{
+		Data_Ptr[i] = INTERNAL_EEPROM_readByte(Address + i);
+	}
+}
+
+/******************************************************************************
+ * Service Name: INTERNAL_EEPROM_isBusy
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters (in): None
+ * Parameters (inout): None
+ * Parameters (out): None
+ * Return value: boolean - TRUE while queued bytes are still being written
+ * Description: The path is busy while bytes are queued or the last one is
+ *              still being programmed into the EEPROM cells.
+ *******************************************************************************/
+boolean INTERNAL_EEPROM_isBusy(void) {
+	return ((g_writeCount != 0) || BIT_IS_SET(EECR,EEWE)) ? TRUE : FALSE;
 }
@@ -15,6 +15,13 @@
 
 #include "..\std_types.h"
 
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* Number of bytes that can wait in the non-blocking write queue */
+#define INTERNAL_EEPROM_WRITE_QUEUE_SIZE	32
+
 /*******************************************************************************
  *                              Functions Prototypes                           *
  *******************************************************************************/
@@ -44,4 +51,46 @@ void INTERNAL_EEPROM_writeByte(uint16 Address, uint8 Data);
  *******************************************************************************/
 uint8 INTERNAL_EEPROM_readByte(uint16 Address);
 
+/******************************************************************************
+ * Service Name: INTERNAL_EEPROM_writeBlockAsync
+ * Sync/Async: Asynchronous
+ * Reentrancy: Reentrant
+ * Parameters (in): Address - The first EEPROM address of the block
+ *                  Data_Ptr - Pointer to the bytes to be written
+ *                  Size - Number of bytes to write
+ * Parameters (inout): None
+ * Parameters (out): None
+ * Return value: boolean - TRUE if the whole block was queued, FALSE if the
+ *                         queue has no room for it (nothing is queued)
+ * Description: Copies the block into the write queue and returns immediately.
+ *              The bytes are programmed one by one from the EEPROM ready
+ *              interrupt, so the caller never waits for the ~8.5ms write time.
+ *******************************************************************************/
+boolean INTERNAL_EEPROM_writeBlockAsync(uint16 Address, const uint8 *Data_Ptr, uint8 Size);
+
+/******************************************************************************
+ * Service Name: INTERNAL_EEPROM_readBlock
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-reentrant
+ * Parameters (in): Address - The first EEPROM address of the block
+ *                  Size - Number of bytes to read
+ * Parameters (inout): None
+ * Parameters (out): Data_Ptr - Buffer that receives the bytes
+ * Return value: None
+ * Description: Reads a block of consecutive bytes from the internal EEPROM.
+ *******************************************************************************/
+void INTERNAL_EEPROM_readBlock(uint16 Address, uint8 *Data_Ptr, uint8 Size);
+
+/******************************************************************************
+ * Service Name: INTERNAL_EEPROM_isBusy
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters (in): None
+ * Parameters (inout): None
+ * Parameters (out): None
+ * Return value: boolean - TRUE while queued bytes are still being written
+ * Description: Reports whether the non-blocking write path still has work to do.
+ *******************************************************************************/
+boolean INTERNAL_EEPROM_isBusy(void);
+
 #endif /* INTERNAL_EEPROM_H_ */
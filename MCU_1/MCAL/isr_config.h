@@ -0,0 +1,45 @@
+ /******************************************************************************
+ *
+ * Module: ISR Configuration
+ *
+ * File Name: isr_config.h
+ *
+ * Description: Compile time binding of the interrupt handlers
+ *
+ * Author: Mohamed Hisham
+ *
+ *******************************************************************************/
+
+#ifndef ISR_CONFIG_H_
+#define ISR_CONFIG_H_
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * A vector whose <VECTOR>_HANDLER is defined here calls that handler directly
+ * instead of the callback registered at run time. With the handler defined as
+ * static inline in the included header, the compiler inlines it into the
+ * vector and saves only the registers it really uses. The callback of a bound
+ * vector is ignored.
+ *
+ * Available: TIMER0_OVF_HANDLER, TIMER1_OVF_HANDLER, TIMER1_COMPA_HANDLER,
+ *            TIMER1_COMPB_HANDLER, TIMER1_CAPT_HANDLER, TIMER2_OVF_HANDLER,
+ *            TIMER2_COMP_HANDLER, ADC_HANDLER, INT0_HANDLER, INT1_HANDLER,
+ *            INT2_HANDLER
+ */
+
+/* System time base tick */
+#include "../SERVICE/timebase_isr.h"
+#define TIMER2_OVF_HANDLER		Time_tick
+
+/* Fan tachometer edges */
+#include "../HAL/tachometer_isr.h"
+#define TIMER1_CAPT_HANDLER		Tacho_edge
+
+/* Fan current samples, taken on each Timer0 PWM period */
+#include "../HAL/current_sensor_isr.h"
+#define ADC_HANDLER				Current_sample
+
+#endif /* ISR_CONFIG_H_ */
@@ -0,0 +1,82 @@
+ /******************************************************************************
+ *
+ * Module: Profile
+ *
+ * File Name: profile.h
+ *
+ * Description: Pin toggling macros to measure code and ISR cycle counts
+ *
+ * Author: Mohamed Hisham
+ *
+ *******************************************************************************/
+
+#ifndef PROFILE_H_
+#define PROFILE_H_
+
+#include <avr/io.h>
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+#define PROFILE_OFF			0
+#define PROFILE_SECTIONS	1 /* The pin is high while a PROFILE_BEGIN/PROFILE_END section runs */
+#define PROFILE_ISR_LOAD	2 /* main toggles the pin forever instead of running the scheduler */
+#define PROFILE_GPIO		3 /* main compares the two ways of writing a pin forever, see gpio_fast.h */
+
+/* Select the measurement, keep PROFILE_OFF in release builds */
+#define PROFILE_MODE		PROFILE_OFF
+
+/* Free pin on both boards, watched with a scope or logic analyzer */
+#define PROFILE_PORT		PORTB
+#define PROFILE_DDR			DDRB
+#define PROFILE_PIN			PB0
+
+/*
+ * At 1MHz one microsecond of the pulse is one CPU cycle.
+ *
+ * PROFILE_SECTIONS: the pulse width is the cycle count of the section plus the
+ * 2 cycles of the sbi instruction.
+ *
+ * PROFILE_ISR_LOAD: the shortest half period seen is one turn of the loop,
+ * it depends on the optimization level. A half period stretched by an
+ * interrupt is longer by the full cost of the ISR: vector jump, prologue,
+ * body, epilogue and reti.
+ *
+ * PROFILE_GPIO: two pulses per loop. The first one lasts one GPIO_writePin
+ * call, from the port write of a call to the port write of the next one. The
+ * second one lasts one GPIO_FAST_CLEAR, the 2 cycles of a cbi. Take the
+ * shortest pulses seen, an interrupt may stretch some of them. The
+ * GPIO_writePin pulse grows with the pin number, and on MCU2, which keeps the
+ * interrupts off around its port write, it is a little longer than on MCU1.
+ */
+#if (PROFILE_MODE != PROFILE_OFF)
+#define PROFILE_INIT()		(PROFILE_DDR |= (1<<PROFILE_PIN))
+#else
+#define PROFILE_INIT()
+#endif
+
+#if (PROFILE_MODE == PROFILE_SECTIONS)
+#define PROFILE_BEGIN()		(PROFILE_PORT |= (1<<PROFILE_PIN))
+#define PROFILE_END()		(PROFILE_PORT &= ~(1<<PROFILE_PIN))
+#else
+#define PROFILE_BEGIN()
+#define PROFILE_END()
+#endif
+
+#if (PROFILE_MODE == PROFILE_ISR_LOAD)
+#define PROFILE_IDLE_LOOP()	for(;;) { PROFILE_PORT ^= (1<<PROFILE_PIN); }
+#elif (PROFILE_MODE == PROFILE_GPIO)
+#include "gpio_fast.h"
+#define PROFILE_PORT_ID		PORTB_ID
+#define PROFILE_IDLE_LOOP()	for(;;) { \
+	GPIO_writePin(PROFILE_PORT_ID, PROFILE_PIN, LOGIC_HIGH); \
+	GPIO_writePin(PROFILE_PORT_ID, PROFILE_PIN, LOGIC_LOW); \
+	GPIO_FAST_SET(PROFILE_PORT_ID, PROFILE_PIN); \
+	GPIO_FAST_CLEAR(PROFILE_PORT_ID, PROFILE_PIN); \
+}
+#else
+#define PROFILE_IDLE_LOOP()
+#endif
+
+#endif /* PROFILE_H_ */
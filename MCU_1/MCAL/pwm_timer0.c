@@ -13,7 +13,33 @@
 #include "pwm_timer0.h"
 #include "gpio.h"  /* to use the gpio Functions */
 #include "avr/io.h" /* to use the timer0 registers */
+#include <avr/interrupt.h> /* For Timer0 ISR */
+#include "isr_config.h" /* For the handlers bound at compile time */
 
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+/* Global variable to hold the address of the callback function in the application */
+static void (*volatile g_callBackPtr)(void) = NULL_PTR;
+
+/*******************************************************************************
+ *                       Interrupt Service Routines                            *
+ *******************************************************************************/
+
+ISR(TIMER0_OVF_vect)
+{
+#ifdef TIMER0_OVF_HANDLER
+	/* Handler bound at compile time, inlined in the vector */
+	TIMER0_OVF_HANDLER();
+#else
+	if(g_callBackPtr != NULL_PTR)
+	{
+		/* Call the Callback function in the application at the end of each PWM period */
+		(*g_callBackPtr)();
+	}
+#endif
+}
 
 /*******************************************************************************
  *                      Functions Definitions                                  *
@@ -25,26 +51,83 @@
  * Generate a PWM signal with frequency 500Hz
  * Timer0 will be used with pre-scaler F_CPU/8
  * F_PWM=(F_CPU)/(256*N) = (10^6)/(256*8) = 500Hz
- * Duty Cycle can be changed by updating the value
- * in The Compare Register
+ * The output starts disconnected (0% duty), PWM_setDuty connects it.
  */
-
-void PWM_Timer0_Start(uint8 duty_cycle)
+void PWM_Timer0_Init(void)
 {
-	float32 duty_cycle_percent = (float32)duty_cycle / 100;
-
 	TCNT0 = 0; //Set Timer Initial value
 
-	OCR0  =  duty_cycle_percent * 255; // Set Compare Value
+	OCR0 = 0; // Set Compare Value
 
 	GPIO_setupPinDirection(PORTB_ID,PIN3_ID,PIN_OUTPUT); //set PB3/OC0 as output pin --> pin where the PWM signal is generated from MC.
+	GPIO_writePin(PORTB_ID,PIN3_ID,LOGIC_LOW); //the pin level while OC0 is disconnected
 
 	/* Configure timer control register
 	 * 1. Fast PWM mode FOC0=0
 	 * 2. Fast PWM Mode WGM01=1 & WGM00=1
-	 * 3. Clear OC0 when match occurs (non inverted mode) COM00=0 & COM01=1
+	 * 3. OC0 disconnected until a duty is set COM00=0 & COM01=0
 	 * 4. clock = F_CPU/8 CS00=0 CS01=1 CS02=0
 	 */
-	TCCR0 = (1<<WGM00) | (1<<WGM01) | (1<<COM01) | (1<<CS01);
+	TCCR0 = (1<<WGM00) | (1<<WGM01) | (1<<CS01);
 }
 
+/*
+ * Description:
+ * Change the duty cycle (0 to PWM_DUTY_MAX permille) while the timer keeps running.
+ * In fast PWM mode OCR0 is double buffered, so the new value is used from the
+ * next period and the current one is never cut. A compare value of 0 still
+ * gives a one count pulse, so 0% disconnects OC0 and leaves the pin low.
+ */
+void PWM_setDuty(uint16 duty_cycle)
+{
+	uint8 compare;
+
+	if (duty_cycle == 0)
+	{
+		TCCR0 &= ~(1<<COM01);
+		return;
+	}
+
+	if (duty_cycle > PWM_DUTY_MAX)
+	{
+		duty_cycle = PWM_DUTY_MAX;
+	}
+
+	/* Rounded duty_cycle * 255 / 1000 */
+	compare = (uint8)(((uint32)duty_cycle * PWM_DUTY_SCALE + 0x8000) >> 16);
+
+	if (OCR0 != compare)
+	{
+		OCR0 = compare;
+	}
+
+	/* Clear OC0 when match occurs (non inverted mode) COM00=0 & COM01=1 */
+	TCCR0 |= (1<<COM01);
+}
+
+/*
+ * Description:
+ * Save the function called from the overflow interrupt, at the end of each PWM period.
+ */
+void PWM_Timer0_setCallBack(void(*a_ptr)(void))
+{
+	/* Save the address of the Callback function in a global variable */
+	g_callBackPtr = a_ptr;
+}
+
+/*
+ * Description:
+ * Enable or disable the overflow interrupt. The flag is kept while it is
+ * disabled, so the first call may come at once.
+ */
+void PWM_Timer0_setOverflowInterrupt(boolean enable)
+{
+	if (enable)
+	{
+		TIMSK |= (1<<TOIE0);
+	}
+	else
+	{
+		TIMSK &= ~(1<<TOIE0);
+	}
+}
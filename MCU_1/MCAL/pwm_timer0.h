@@ -14,6 +14,16 @@
 
 #include "..\std_types.h"
 
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* Duty cycles are given in permille, 1000 is always on */
+#define PWM_DUTY_MAX		1000
+
+/* 255/1000 in Q16, turns a duty cycle into a compare value without a division */
+#define PWM_DUTY_SCALE		16712UL
+
 /*******************************************************************************
  *                              Functions Prototypes                           *
  *******************************************************************************/
@@ -23,10 +33,30 @@
  * Generate a PWM signal with frequency 500Hz
  * Timer0 will be used with pre-scaler F_CPU/8
  * F_PWM=(F_CPU)/(256*N) = (10^6)/(256*8) = 500Hz
- * Duty Cycle can be changed by updating the value
- * in The Compare Register
+ * Called once, the output starts at 0% duty.
+ */
+void PWM_Timer0_Init(void);
+
+/*
+ * Description:
+ * Change the duty cycle (0 to PWM_DUTY_MAX permille) while the timer keeps
+ * running. OCR0 is only written when the value changes, the new value takes
+ * effect at the end of the current PWM period.
+ */
+void PWM_setDuty(uint16 duty_cycle);
+
+/*
+ * Description:
+ * Save the function called from the overflow interrupt, at the end of each
+ * PWM period (about 490 times a second).
+ */
+void PWM_Timer0_setCallBack(void(*a_ptr)(void));
+
+/*
+ * Description:
+ * Enable or disable the overflow interrupt, it is off after PWM_Timer0_Init.
  */
-void PWM_Timer0_Start(uint8 duty_cycle);
+void PWM_Timer0_setOverflowInterrupt(boolean enable);
 
 
 #endif /* PWM_TIMER0_H_ */
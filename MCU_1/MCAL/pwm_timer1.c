@@ -0,0 +1,118 @@
+ /*******************************************************************************
+ * Module: timer1
+ *
+ * File Name: pwm_timer1.c
+ *
+ * Description: Source file for PWM timer1
+ *
+ * Author: Mohamed Hisham
+ *
+ *******************************************************************************/
+
+#include "pwm_timer1.h"
+#include "gpio.h"  /* to use the gpio Functions */
+#include <avr/io.h> /* to use the timer1 registers */
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+static uint32 g_dutyScale = 0;   /* TOP/1000 in Q16 */
+static uint16 g_compare[2] = {0, 0}; /* Compare value in use of each channel */
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * Description:
+ * Generate phase correct PWM signals on OC1A (PD5) and OC1B (PD4) with the TOP in ICR1.
+ * Timer1 will be used without pre-scaler
+ * F_PWM=(F_CPU)/(2*TOP) --> TOP=(F_CPU)/(2*F_PWM)
+ * The duty scale is computed here once, so PWM_Timer1_setDuty needs no division.
+ */
+void PWM_Timer1_Init(uint32 frequency)
+{
+	Timer1_ConfigType timer_config;
+	uint16 top;
+
+	if (frequency == 0)
+	{
+		return;
+	}
+
+	top = (uint16)(F_CPU / (2 * frequency));
+	g_dutyScale = ((uint32)top << 16) / PWM_TIMER1_DUTY_MAX;
+	g_compare[TIMER1_CHANNEL_A] = 0;
+	g_compare[TIMER1_CHANNEL_B] = 0;
+
+	/* Clear OC1A/OC1B on compare match when up-counting (non inverted mode), a
+	 * compare value of 0 keeps the output low and TOP keeps it high */
+	timer_config.initial_value = 0;
+	timer_config.compare_value = 0;
+	timer_config.compare_b_value = 0;
+	timer_config.top_value = top;
+	timer_config.prescaler = PRESCALER_1;
+	timer_config.mode = PHASE_CORRECT_PWM_MODE;
+	timer_config.output_a = OUTPUT_CLEAR;
+	timer_config.output_b = OUTPUT_CLEAR;
+	timer_config.capture_edge = CAPTURE_FALLING_EDGE;
+	Timer1_init(&timer_config);
+}
+
+/*
+ * Description:
+ * Set the pin of a channel as output, the compare output unit only drives the
+ * pins set as output.
+ */
+void PWM_Timer1_enableChannel(Timer1_Channel channel)
+{
+	if (channel == TIMER1_CHANNEL_A)
+	{
+		GPIO_setupPinDirection(PORTD_ID,PIN5_ID,PIN_OUTPUT); //set PD5/OC1A as output pin --> pin where the PWM signal is generated from MC.
+		GPIO_writePin(PORTD_ID,PIN5_ID,LOGIC_LOW); //the pin level while OC1A is disconnected
+	}
+	else
+	{
+		GPIO_setupPinDirection(PORTD_ID,PIN4_ID,PIN_OUTPUT); //set PD4/OC1B as output pin
+		GPIO_writePin(PORTD_ID,PIN4_ID,LOGIC_LOW); //the pin level while OC1B is disconnected
+	}
+}
+
+/*
+ * Description:
+ * Change the duty cycle (0 to PWM_TIMER1_DUTY_MAX permille) of a channel while
+ * the timer keeps running. OCR1A/OCR1B are double buffered in PWM mode and
+ * updated at TOP, so the running period is never cut. 0% disconnects the
+ * output at once instead, so a motor bridge can rely on its enable falling
+ * right away.
+ */
+void PWM_Timer1_setDuty(Timer1_Channel channel, uint16 duty_cycle)
+{
+	uint16 compare;
+	uint8 com = (channel == TIMER1_CHANNEL_A) ? (1<<COM1A1) : (1<<COM1B1);
+
+	if (duty_cycle == 0)
+	{
+		TCCR1A &= ~com;
+	}
+	else
+	{
+		/* Clear OC1A/OC1B on compare match when up-counting (non inverted mode) */
+		TCCR1A |= com;
+	}
+
+	if (duty_cycle > PWM_TIMER1_DUTY_MAX)
+	{
+		duty_cycle = PWM_TIMER1_DUTY_MAX;
+	}
+
+	/* Rounded duty_cycle * TOP / 1000 */
+	compare = (uint16)(((uint32)duty_cycle * g_dutyScale + 0x8000) >> 16);
+
+	if (compare != g_compare[channel])
+	{
+		g_compare[channel] = compare;
+		Timer1_setCompareValue(channel, compare);
+	}
+}
@@ -0,0 +1,71 @@
+ /*******************************************************************************
+ * Module: timer2
+ *
+ * File Name: pwm_timer2.c
+ *
+ * Description: Source file for PWM timer2
+ *
+ * Author: Mohamed Hisham
+ *
+ *******************************************************************************/
+
+#include "pwm_timer2.h"
+#include "gpio.h"  /* to use the gpio Functions */
+#include <avr/io.h> /* to use the timer2 registers */
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * Description:
+ * Generate a PWM signal on OC2 (PD7) from the Timer2 of the system time base.
+ * Only the mode bits are changed, the counter, the pre-scaler and the overflow
+ * interrupt of the time base are kept. Fast PWM counts 0 to 255 like the
+ * normal mode, so each overflow still comes after 256 counts.
+ * The output starts disconnected (0% duty), PWM_Timer2_setDuty connects it.
+ */
+void PWM_Timer2_Init(void)
+{
+	OCR2 = 0; // Set Compare Value
+
+	GPIO_setupPinDirection(PORTD_ID,PIN7_ID,PIN_OUTPUT); //set PD7/OC2 as output pin --> pin where the PWM signal is generated from MC.
+	GPIO_writePin(PORTD_ID,PIN7_ID,LOGIC_LOW); //the pin level while OC2 is disconnected
+
+	/* Fast PWM Mode WGM21=1 & WGM20=1, OC2 disconnected until a duty is set COM20=0 & COM21=0 */
+	TCCR2 = (TCCR2 & ~((1<<COM21) | (1<<COM20))) | (1<<WGM21) | (1<<WGM20);
+}
+
+/*
+ * Description:
+ * Change the duty cycle (0 to PWM_TIMER2_DUTY_MAX permille) while the timer keeps running.
+ * In fast PWM mode OCR2 is double buffered, so the new value is used from the
+ * next period and the current one is never cut. A compare value of 0 still
+ * gives a one count pulse, so 0% disconnects OC2 and leaves the pin low.
+ */
+void PWM_Timer2_setDuty(uint16 duty_cycle)
+{
+	uint8 compare;
+
+	if (duty_cycle == 0)
+	{
+		TCCR2 &= ~(1<<COM21);
+		return;
+	}
+
+	if (duty_cycle > PWM_TIMER2_DUTY_MAX)
+	{
+		duty_cycle = PWM_TIMER2_DUTY_MAX;
+	}
+
+	/* Rounded duty_cycle * 255 / 1000 */
+	compare = (uint8)(((uint32)duty_cycle * PWM_TIMER2_DUTY_SCALE + 0x8000) >> 16);
+
+	if (OCR2 != compare)
+	{
+		OCR2 = compare;
+	}
+
+	/* Clear OC2 when match occurs (non inverted mode) COM20=0 & COM21=1 */
+	TCCR2 |= (1<<COM21);
+}
@@ -0,0 +1,72 @@
+/******************************************************************************
+ *
+ * Module: Reset
+ *
+ * File Name: reset.c
+ *
+ * Description: Source file for the reset cause driver
+ *
+ * Author: Mohamed Hisham
+ *
+ *******************************************************************************/
+
+#include "reset.h"
+#include "..\common_macros.h"
+#include <avr/io.h>
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+#define RESET_FLAGS_MASK	((1<<JTRF) | (1<<WDRF) | (1<<BORF) | (1<<EXTRF) | (1<<PORF))
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+/******************************************************************************
+ * Service Name: RESET_getCause
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-reentrant
+ * Parameters (in): None
+ * Parameters (inout): None
+ * Parameters (out): None
+ * Return value: Reset_CauseType - The source of the last reset
+ * Description: The flags are only cleared by software, so several of them can be
+ *              set. A power-on reset sets the others as well, so it is checked first.
+ *******************************************************************************/
+Reset_CauseType RESET_getCause(void)
+{
+	uint8 flags = MCUCSR & RESET_FLAGS_MASK;
+	Reset_CauseType cause;
+
+	/* Clear the reset flags, keep the JTD and ISC2 bits */
+	MCUCSR &= ~RESET_FLAGS_MASK;
+
+	if (BIT_IS_SET(flags,PORF))
+	{
+		cause = RESET_POWER_ON;
+	}
+	else if (BIT_IS_SET(flags,BORF))
+	{
+		cause = RESET_BROWN_OUT;
+	}
+	else if (BIT_IS_SET(flags,WDRF))
+	{
+		cause = RESET_WATCHDOG;
+	}
+	else if (BIT_IS_SET(flags,EXTRF))
+	{
+		cause = RESET_EXTERNAL;
+	}
+	else if (BIT_IS_SET(flags,JTRF))
+	{
+		cause = RESET_JTAG;
+	}
+	else
+	{
+		cause = RESET_UNKNOWN;
+	}
+
+	return cause;
+}
@@ -0,0 +1,48 @@
+/******************************************************************************
+ *
+ * Module: Reset
+ *
+ * File Name: reset.h
+ *
+ * Description: Header file for the reset cause driver
+ *
+ * Author: Mohamed Hisham
+ *
+ *******************************************************************************/
+
+#ifndef RESET_H_
+#define RESET_H_
+
+#include "..\std_types.h"
+
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+
+typedef enum {
+	RESET_POWER_ON,
+	RESET_EXTERNAL,
+	RESET_BROWN_OUT,
+	RESET_WATCHDOG,
+	RESET_JTAG,
+	RESET_UNKNOWN
+} Reset_CauseType;
+
+/*******************************************************************************
+ *                              Functions Prototypes                           *
+ *******************************************************************************/
+
+/******************************************************************************
+ * Service Name: RESET_getCause
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-reentrant
+ * Parameters (in): None
+ * Parameters (inout): None
+ * Parameters (out): None
+ * Return value: Reset_CauseType - The source of the last reset
+ * Description: Reads the reset flags in MCUCSR and clears them, so the next
+ *              reset is reported alone. Must be called once, early at start-up.
+ *******************************************************************************/
+Reset_CauseType RESET_getCause(void);
+
+#endif /* RESET_H_ */
@@ -13,13 +13,57 @@
 #include "timer1.h"
 #include <avr/io.h> /* To use ICU/Timer1 Registers */
 #include <avr/interrupt.h> /* For ICU ISR */
+#include "isr_config.h" /* For the handlers bound at compile time */
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+#define TIMER1_INTERRUPTS_MASK	((1<<TICIE1) | (1<<OCIE1A) | (1<<OCIE1B) | (1<<TOIE1))
+
+/* Interrupts of the vectors bound at compile time, always enabled by Timer1_init */
+#ifdef TIMER1_OVF_HANDLER
+#define TIMER1_OVF_BOUND		(1<<TOIE1)
+#else
+#define TIMER1_OVF_BOUND		0
+#endif
+
+#ifdef TIMER1_COMPA_HANDLER
+#define TIMER1_COMPA_BOUND		(1<<OCIE1A)
+#else
+#define TIMER1_COMPA_BOUND		0
+#endif
+
+#ifdef TIMER1_COMPB_HANDLER
+#define TIMER1_COMPB_BOUND		(1<<OCIE1B)
+#else
+#define TIMER1_COMPB_BOUND		0
+#endif
+
+#ifdef TIMER1_CAPT_HANDLER
+#define TIMER1_CAPT_BOUND		(1<<TICIE1)
+#else
+#define TIMER1_CAPT_BOUND		0
+#endif
+
+#define TIMER1_BOUND_INTERRUPTS	(TIMER1_OVF_BOUND | TIMER1_COMPA_BOUND | TIMER1_COMPB_BOUND | TIMER1_CAPT_BOUND)
 
 /*******************************************************************************
  *                           Global Variables                                  *
  *******************************************************************************/
 
-/* Global variable to hold the address of the callback function in the application */
-static volatile void (*g_callBackPtr)(void) = NULL_PTR;
+/* Global variables to hold the address of the callback function of each event in the application */
+static void (*volatile g_callBackPtr[TIMER1_EVENTS_COUNT])(void) = {
+	NULL_PTR, NULL_PTR, NULL_PTR, NULL_PTR
+};
+
+/* Interrupt enable and flag bits of each event, in Timer1_Event order */
+static const uint8 g_interruptEnable[TIMER1_EVENTS_COUNT] = {
+	(1<<TOIE1), (1<<OCIE1A), (1<<OCIE1B), (1<<TICIE1)
+};
+static const uint8 g_interruptFlag[TIMER1_EVENTS_COUNT] = {
+	(1<<TOV1), (1<<OCF1A), (1<<OCF1B), (1<<ICF1)
+};
 
 /*******************************************************************************
  *                       Interrupt Service Routines                            *
@@ -27,20 +71,58 @@ static volatile void (*g_callBackPtr)(void) = NULL_PTR;
 
 ISR(TIMER1_OVF_vect)
 {
-	if(g_callBackPtr != NULL_PTR)
+#ifdef TIMER1_OVF_HANDLER
+	/* Handler bound at compile time, inlined in the vector */
+	TIMER1_OVF_HANDLER();
+#else
+	if(g_callBackPtr[TIMER1_OVERFLOW_EVENT] != NULL_PTR)
 	{
 		/* Call the Callback function in the application after overflow */
-		(*g_callBackPtr)(); /* Another method to call the function using pointer to function: g_callBackPtr(); */
+		(*g_callBackPtr[TIMER1_OVERFLOW_EVENT])();
 	}
+#endif
 }
 
 ISR(TIMER1_COMPA_vect)
 {
-	if(g_callBackPtr != NULL_PTR)
+#ifdef TIMER1_COMPA_HANDLER
+	/* Handler bound at compile time, inlined in the vector */
+	TIMER1_COMPA_HANDLER();
+#else
+	if(g_callBackPtr[TIMER1_COMPARE_A_EVENT] != NULL_PTR)
+	{
+		/* Call the Callback function in the application after reaching the channel A compare value */
+		(*g_callBackPtr[TIMER1_COMPARE_A_EVENT])();
+	}
+#endif
+}
+
+ISR(TIMER1_COMPB_vect)
+{
+#ifdef TIMER1_COMPB_HANDLER
+	/* Handler bound at compile time, inlined in the vector */
+	TIMER1_COMPB_HANDLER();
+#else
+	if(g_callBackPtr[TIMER1_COMPARE_B_EVENT] != NULL_PTR)
 	{
-		/* Call the Callback function in the application after reaching the compare value */
-		(*g_callBackPtr)(); /* Another method to call the function using pointer to function: g_callBackPtr(); */
+		/* Call the Callback function in the application after reaching the channel B compare value */
+		(*g_callBackPtr[TIMER1_COMPARE_B_EVENT])();
 	}
+#endif
+}
+
+ISR(TIMER1_CAPT_vect)
+{
+#ifdef TIMER1_CAPT_HANDLER
+	/* Handler bound at compile time, inlined in the vector */
+	TIMER1_CAPT_HANDLER();
+#else
+	if(g_callBackPtr[TIMER1_CAPTURE_EVENT] != NULL_PTR)
+	{
+		/* Call the Callback function in the application after a capture edge */
+		(*g_callBackPtr[TIMER1_CAPTURE_EVENT])();
+	}
+#endif
 }
 
 /*******************************************************************************
@@ -49,36 +131,66 @@ ISR(TIMER1_COMPA_vect)
 
 void Timer1_init(const Timer1_ConfigType * Config_Ptr)
 {
+	uint8 interrupts = TIMER1_BOUND_INTERRUPTS;
+	uint8 event;
+
 	/* Null pointer check */
 	if (Config_Ptr == NULL_PTR)
 	{
 		return;
 	}
 
-	/* Configure Timer1 Control Registers */
-	TCCR1A = (1<<FOC1A);
-	TCCR1B = (Config_Ptr->mode << WGM12);
-	TCCR1B |= (Config_Ptr->prescaler);
+	/* Stop the timer while it is configured */
+	TCCR1B = 0;
+
+	/* Configure the compare outputs */
+	TCCR1A = (Config_Ptr->output_a << COM1A0) | (Config_Ptr->output_b << COM1B0);
 
-	/* Set Timer1 initial value */
+	/* Set Timer1 initial and compare values */
 	TCNT1 = Config_Ptr->initial_value;
+	OCR1A = Config_Ptr->compare_value;
+	OCR1B = Config_Ptr->compare_b_value;
 
-	if (Config_Ptr->mode == COMPARE_MODE)
+	switch (Config_Ptr->mode)
 	{
-		/* Set compare value */
-		OCR1A = Config_Ptr->compare_value;
-
-		/* Enable Compare Match Interrupt */
-		TIMSK = (1<<OCIE1A);
+	case COMPARE_MODE:
+		/* CTC with the TOP in OCR1A (Mode Number 4) */
+		TCCR1B = (1<<WGM12);
+		break;
+	case FAST_PWM_MODE:
+		/* Fast PWM with the TOP in ICR1 (Mode Number 14) */
+		ICR1 = Config_Ptr->top_value;
+		TCCR1A |= (1<<WGM11);
+		TCCR1B = (1<<WGM12) | (1<<WGM13);
+		break;
+	case PHASE_CORRECT_PWM_MODE:
+		/* Phase correct PWM with the TOP in ICR1 (Mode Number 10) */
+		ICR1 = Config_Ptr->top_value;
+		TCCR1A |= (1<<WGM11);
+		TCCR1B = (1<<WGM13);
+		break;
+	case INPUT_CAPTURE_MODE:
+		/* Normal counting, noise canceler on and the selected capture edge */
+		TCCR1B = (1<<ICNC1) | (Config_Ptr->capture_edge << ICES1);
+		break;
+	default:
+		break;
 	}
-	else
+
+	/* Clear any pending interrupts, then enable the bound ones and the ones that have a callback */
+	TIFR = (1<<ICF1) | (1<<OCF1A) | (1<<OCF1B) | (1<<TOV1);
+	for (event = 0; event < TIMER1_EVENTS_COUNT; event++)
 	{
-		/* Enable Overflow Interrupt */
-		TIMSK = (1<<TOIE1);
+		if (g_callBackPtr[event] != NULL_PTR)
+		{
+			interrupts |= g_interruptEnable[event];
+		}
 	}
+	/* Only touch the Timer1 bits, the other timers share TIMSK */
+	TIMSK = (TIMSK & ~TIMER1_INTERRUPTS_MASK) | interrupts;
 
-	/* Clear any pending interrupts */
-	TIFR = (1<<OCF1A) | (1<<TOV1);
+	/* Start the timer */
+	TCCR1B |= (Config_Ptr->prescaler);
 }
 
 void Timer1_deInit(void)
@@ -88,13 +200,79 @@ void Timer1_deInit(void)
 	TCCR1B = 0;
 	TCNT1 = 0;
 	OCR1A = 0;
+	OCR1B = 0;
+	ICR1 = 0;
 
 	/* Disable Timer1 Interrupts */
-	TIMSK = 0;
+	TIMSK &= ~TIMER1_INTERRUPTS_MASK;
 }
 
-void Timer1_setCallBack(void(*a_ptr)(void))
+void Timer1_setCallBack(Timer1_Event event, void(*a_ptr)(void))
 {
+	uint8 sreg = SREG;
+
+	if (event >= TIMER1_EVENTS_COUNT)
+	{
+		return;
+	}
+
+	cli();
 	/* Save the address of the Callback function in a global variable */
-	g_callBackPtr = a_ptr;
+	g_callBackPtr[event] = a_ptr;
+
+	if (a_ptr != NULL_PTR)
+	{
+		/* Drop an old pending event before enabling its interrupt */
+		TIFR = g_interruptFlag[event];
+		TIMSK |= g_interruptEnable[event];
+	}
+	else
+	{
+		TIMSK &= ~g_interruptEnable[event];
+	}
+	SREG = sreg;
+}
+
+void Timer1_setCompareValue(Timer1_Channel channel, uint16 value)
+{
+	uint8 sreg = SREG;
+
+	/* The 16-bit registers share one temporary byte with the ISRs */
+	cli();
+	if (channel == TIMER1_CHANNEL_A)
+	{
+		OCR1A = value;
+	}
+	else
+	{
+		OCR1B = value;
+	}
+	SREG = sreg;
+}
+
+void Timer1_setCaptureEdge(Timer1_CaptureEdge edge)
+{
+	if (edge == CAPTURE_RISING_EDGE)
+	{
+		TCCR1B |= (1<<ICES1);
+	}
+	else
+	{
+		TCCR1B &= ~(1<<ICES1);
+	}
+
+	/* Changing the edge can set the capture flag */
+	TIFR = (1<<ICF1);
+}
+
+uint16 Timer1_getCaptureValue(void)
+{
+	uint16 value;
+	uint8 sreg = SREG;
+
+	cli();
+	value = ICR1;
+	SREG = sreg;
+
+	return value;
 }
@@ -0,0 +1,67 @@
+ /******************************************************************************
+ *
+ * Module: Timer2
+ *
+ * File Name: timer2.h
+ *
+ * Description: Header file for Timer2
+ *
+ * Author: Mohamed Hisham
+ *
+ *******************************************************************************/
+
+#ifndef TIMER2_H_
+#define TIMER2_H_
+
+#include "..\std_types.h"
+
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+
+typedef enum{
+	TIMER2_NO_CLOCK, TIMER2_PRESCALER_1, TIMER2_PRESCALER_8, TIMER2_PRESCALER_32, TIMER2_PRESCALER_64,
+	TIMER2_PRESCALER_128, TIMER2_PRESCALER_256, TIMER2_PRESCALER_1024
+} Timer2_Prescaler;
+
+typedef enum{
+	TIMER2_NORMAL_MODE, TIMER2_COMPARE_MODE
+} Timer2_Mode;
+
+typedef struct {
+	uint8 initial_value;
+	uint8 compare_value; // It will be used in compare mode only.
+	Timer2_Prescaler prescaler;
+	Timer2_Mode mode;
+} Timer2_ConfigType;
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+
+/*
+ * Description:
+ * Function to initialize the Timer driver
+ * Inputs: pointer to the configuration structure with type Timer2_ConfigType.
+ * Return: None
+ */
+void Timer2_init(const Timer2_ConfigType * Config_Ptr);
+
+/*
+ * Description:
+ * Function to disable the Timer2.
+ * Inputs: None
+ * Return: None
+ */
+void Timer2_deInit(void);
+
+/*
+ * Description:
+ * Function to set the Callback function address. It has no effect on the
+ * dispatch of a vector bound in isr_config.h.
+ * Inputs: pointer to Callback function.
+ * Return: None
+ */
+void Timer2_setCallBack(void(*a_ptr)(void));
+
+#endif /* TIMER2_H_ */
@@ -12,8 +12,44 @@
 
 #include "uart.h"
 #include "avr/io.h" /* To use the UART Registers */
+#include <avr/interrupt.h> /* For the RX complete ISR */
 #include "..\common_macros.h" /* To use the macros like SET_BIT */
 
+#if (UART_RX_BUFFER_SIZE & (UART_RX_BUFFER_SIZE - 1)) != 0
+#error "UART_RX_BUFFER_SIZE must be a power of 2"
+#endif
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+/*
+ * Receive ring buffer, written by the ISR at the head and read by the thread
+ * at the tail. Each index has a single writer and is a single byte, so
+ * neither side needs to turn the interrupts off.
+ */
+static volatile uint8 g_rxBuffer[UART_RX_BUFFER_SIZE];
+static volatile uint8 g_rxHead = 0;
+static volatile uint8 g_rxTail = 0;
+
+/*******************************************************************************
+ *                       Interrupt Service Routines                            *
+ *******************************************************************************/
+
+ISR(USART_RXC_vect)
+{
+	/* Reading UDR clears the RXC flag, even when the byte is dropped */
+	uint8 data = UDR;
+	uint8 head = g_rxHead;
+	uint8 next = (head + 1) & (UART_RX_BUFFER_SIZE - 1);
+
+	if(next != g_rxTail)
+	{
+		g_rxBuffer[head] = data;
+		g_rxHead = next;
+	}
+}
+
 /*******************************************************************************
  *                      Functions Definitions                                  *
  *******************************************************************************/
@@ -33,7 +69,7 @@ void UART_init(const UART_ConfigType * Config_Ptr)
 	UCSRA = (1<<U2X);
 
 	/************************** UCSRB Description **************************
-	 * RXCIE = 0 Disable USART RX Complete Interrupt Enable
+	 * RXCIE = 1 Enable USART RX Complete Interrupt Enable, fills the receive buffer
 	 * TXCIE = 0 Disable USART Tx Complete Interrupt Enable
 	 * UDRIE = 0 Disable USART Data Register Empty Interrupt Enable
 	 * RXEN  = 1 Receiver Enable
@@ -41,7 +77,7 @@ void UART_init(const UART_ConfigType * Config_Ptr)
 	 * UCSZ2 = 0 For 8-bit data mode
 	 * RXB8 & TXB8 not used for 8-bit data mode
 	 ***********************************************************************/ 
-	UCSRB = (1<<RXEN) | (1<<TXEN);
+	UCSRB = (1<<RXCIE) | (1<<RXEN) | (1<<TXEN);
 	UCSRB |= ((Config_Ptr->bit_data >> 2)<<UCSZ2);
 	/************************** UCSRC Description **************************
 	 * URSEL   = 1 The URSEL must be one when writing the UCSRC
@@ -89,17 +125,36 @@ void UART_sendByte(const uint8 data)
 /*
  * Description :
  * Functional responsible for receive byte from another UART device.
+ * Waits until a byte is in the receive buffer.
  */
 uint8 UART_recieveByte(void)
 {
-	/* RXC flag is set when the UART receive data so wait until this flag is set to one */
-	while(BIT_IS_CLEAR(UCSRA,RXC)){}
+	uint8 data;
 
-	/*
-	 * Read the received data from the Rx buffer (UDR)
-	 * The RXC flag will be cleared after read the data
-	 */
-    return UDR;		
+	/* The RX complete interrupt puts the received bytes in the buffer, wait for one */
+	while(!UART_tryReceiveByte(&data)){}
+
+	return data;
+}
+
+/*
+ * Description :
+ * Check for a received byte in the receive buffer without waiting for it.
+ * Returns TRUE and stores the byte in the given location if one was received,
+ * otherwise returns FALSE immediately.
+ */
+boolean UART_tryReceiveByte(uint8 *data_Ptr)
+{
+	uint8 tail = g_rxTail;
+
+	if(tail == g_rxHead)
+	{
+		return FALSE;
+	}
+
+	*data_Ptr = g_rxBuffer[tail];
+	g_rxTail = (tail + 1) & (UART_RX_BUFFER_SIZE - 1);
+	return TRUE;
 }
 
 /*
@@ -15,6 +15,16 @@
 
 #include "..\std_types.h"
 
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * Bytes received by the RX complete interrupt and not read yet, a power of 2.
+ * 32 bytes last 33ms at 9600 baud, longer than any task of the schedulers.
+ * Bytes received while it is full are dropped.
+ */
+#define UART_RX_BUFFER_SIZE		32
 
 /*******************************************************************************
  *                               Types Declaration                             *
@@ -63,9 +73,18 @@ void UART_sendByte(const uint8 data);
 /*
  * Description :
  * Functional responsible for receive byte from another UART device.
+ * Waits until a byte is in the receive buffer.
  */
 uint8 UART_recieveByte(void);
 
+/*
+ * Description :
+ * Check for a received byte in the receive buffer without waiting for it.
+ * Returns TRUE and stores the byte in the given location if one was received,
+ * otherwise returns FALSE immediately.
+ */
+boolean UART_tryReceiveByte(uint8 *data_Ptr);
+
 /*
  * Description :
  * Send the required string through UART to the other UART device.
@@ -0,0 +1,184 @@
+ /******************************************************************************
+ *
+ * Module: Configuration
+ *
+ * File Name: config.c
+ *
+ * Description: Source file for the EEPROM persisted runtime configuration
+ *
+ * Author: Mohamed Hisham
+ *
+ *******************************************************************************/
+
+#include "config.h"
+#include "nvm_layout.h"
+#include "../MCAL/internal_EEPROM.h"
+#include "link.h"
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+/* RAM copy of the configuration */
+static Config_Type g_config;
+
+/* The block is sent whole in one link frame */
+typedef char Config_FrameSizeCheck[(sizeof(Config_Type) <= LINK_MAX_PAYLOAD) ? 1 : -1];
+
+/*******************************************************************************
+ *                      Private Functions Definitions                          *
+ *******************************************************************************/
+
+/* Sum of all the bytes of the block except the checksum, negated */
+static uint8 Config_computeChecksum(const Config_Type *Config_Ptr)
+{
+	const uint8 *bytes = (const uint8*)Config_Ptr;
+	uint8 sum = 0;
+	uint8 i;
+
+	for (i = 0; i < (sizeof(Config_Type) - 1); i++)
+	{
+		sum += bytes[i];
+	}
+
+	return (uint8)(0 - sum);
+}
+
+/*
+ * The emergency band starts at emergencyTemperature + 1, a 0 tick period would
+ * be a soft timer that never waits and a 0 timeout would end every emergency
+ * in the abnormal state at once.
+ */
+static boolean Config_isValid(const Config_Type *Config_Ptr)
+{
+	return ((Config_Ptr->version == CONFIG_VERSION) &&
+			(Config_Ptr->checksum == Config_computeChecksum(Config_Ptr)) &&
+			(Config_Ptr->fanStartTemperature < Config_Ptr->fanFullTemperature) &&
+			(Config_Ptr->fanFullTemperature <= Config_Ptr->emergencyTemperature) &&
+			(Config_Ptr->emergencyTemperature < CONFIG_MAX_TEMPERATURE) &&
+			(Config_Ptr->emergencyTimeoutTicks != 0) &&
+			(Config_Ptr->emergencyTickPeriod >= CONFIG_MIN_EMERGENCY_TICK_PERIOD) &&
+			(Config_Ptr->targetTemperature >= Config_Ptr->fanStartTemperature) &&
+			(Config_Ptr->targetTemperature < Config_Ptr->fanFullTemperature) &&
+			(Config_Ptr->baudRate != 0)) ? TRUE : FALSE;
+}
+
+static void Config_loadDefaults(Config_Type *Config_Ptr)
+{
+	Config_Ptr->version = CONFIG_VERSION;
+	Config_Ptr->fanStartTemperature = CONFIG_DEFAULT_FAN_START_TEMPERATURE;
+	Config_Ptr->fanFullTemperature = CONFIG_DEFAULT_FAN_FULL_TEMPERATURE;
+	Config_Ptr->emergencyTemperature = CONFIG_DEFAULT_EMERGENCY_TEMPERATURE;
+	Config_Ptr->emergencyTimeoutTicks = CONFIG_DEFAULT_EMERGENCY_TIMEOUT_TICKS;
+	Config_Ptr->emergencyTickPeriod = CONFIG_DEFAULT_EMERGENCY_TICK_PERIOD;
+	Config_Ptr->targetTemperature = CONFIG_DEFAULT_TARGET_TEMPERATURE;
+	Config_Ptr->pidKp = CONFIG_DEFAULT_PID_KP;
+	Config_Ptr->pidKi = CONFIG_DEFAULT_PID_KI;
+	Config_Ptr->pidKd = CONFIG_DEFAULT_PID_KD;
+	Config_Ptr->baudRate = CONFIG_DEFAULT_BAUD_RATE;
+	Config_Ptr->checksum = Config_computeChecksum(Config_Ptr);
+}
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+/******************************************************************************
+ * Service Name: Config_init
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-reentrant
+ * Parameters (in): None
+ * Parameters (inout): None
+ * Parameters (out): None
+ * Return value: None
+ * Description: Loads the configuration block from the EEPROM into RAM. If the
+ *              stored block has another version or a wrong checksum, the
+ *              defaults are used and written back to the EEPROM.
+ *******************************************************************************/
+void Config_init(void)
+{
+	INTERNAL_EEPROM_readBlock(NVM_CONFIG_ADDRESS, (uint8*)&g_config, sizeof(Config_Type));
+
+	if (!Config_isValid(&g_config))
+	{
+		Config_loadDefaults(&g_config);
+		INTERNAL_EEPROM_writeBlockAsync(NVM_CONFIG_ADDRESS, (const uint8*)&g_config, sizeof(Config_Type));
+	}
+}
+
+/******************************************************************************
+ * Service Name: Config_get
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters (in): None
+ * Parameters (inout): None
+ * Parameters (out): None
+ * Return value: const Config_Type* - The configuration held in RAM
+ * Description: Returns the RAM copy of the configuration, hot paths read it
+ *              directly instead of going to the EEPROM.
+ *******************************************************************************/
+const Config_Type* Config_get(void)
+{
+	return &g_config;
+}
+
+/******************************************************************************
+ * Service Name: Config_update
+ * Sync/Async: Asynchronous
+ * Reentrancy: Non-reentrant
+ * Parameters (in): Config_Ptr - The new configuration block
+ * Parameters (inout): None
+ * Parameters (out): None
+ * Return value: boolean - TRUE if the block was valid and accepted
+ * Description: Checks the version, checksum, thresholds order and field ranges
+ *              of the block, then replaces the RAM copy and queues the EEPROM
+ *              write. A block equal to the one in use is not written again.
+ *******************************************************************************/
+boolean Config_update(const Config_Type *Config_Ptr)
+{
+	const uint8 *new_bytes = (const uint8*)Config_Ptr;
+	const uint8 *bytes = (const uint8*)&g_config;
+	uint8 i;
+
+	if ((Config_Ptr == NULL_PTR) || !Config_isValid(Config_Ptr))
+	{
+		return FALSE;
+	}
+
+	for (i = 0; i < sizeof(Config_Type); i++)
+	{
+		if (new_bytes[i] != bytes[i])
+		{
+			break;
+		}
+	}
+	if (i == sizeof(Config_Type))
+	{
+		return TRUE;
+	}
+
+	if (!INTERNAL_EEPROM_writeBlockAsync(NVM_CONFIG_ADDRESS, (const uint8*)Config_Ptr, sizeof(Config_Type)))
+	{
+		return FALSE;
+	}
+
+	g_config = *Config_Ptr;
+
+	return TRUE;
+}
+
+/******************************************************************************
+ * Service Name: Config_send
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-reentrant
+ * Parameters (in): None
+ * Parameters (inout): None
+ * Parameters (out): None
+ * Return value: None
+ * Description: Sends the RAM copy of the configuration in a LINK_CONFIG frame,
+ *              its length and checksum let the receiver drop a damaged block.
+ *******************************************************************************/
+void Config_send(void)
+{
+	Link_sendFrame(LINK_CONFIG, (const uint8*)&g_config, sizeof(Config_Type));
+}
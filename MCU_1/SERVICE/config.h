@@ -0,0 +1,125 @@
+ /******************************************************************************
+ *
+ * Module: Configuration
+ *
+ * File Name: config.h
+ *
+ * Description: Header file for the EEPROM persisted runtime configuration
+ *
+ * Author: Mohamed Hisham
+ *
+ *******************************************************************************/
+
+#ifndef CONFIG_H_
+#define CONFIG_H_
+
+#include "..\std_types.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* Increment whenever Config_Type changes, stored blocks of other versions are replaced by the defaults */
+#define CONFIG_VERSION							3
+
+/* Default values, shared by both MCUs */
+#define CONFIG_DEFAULT_FAN_START_TEMPERATURE	20
+#define CONFIG_DEFAULT_FAN_FULL_TEMPERATURE		40
+#define CONFIG_DEFAULT_EMERGENCY_TEMPERATURE	50
+#define CONFIG_DEFAULT_EMERGENCY_TIMEOUT_TICKS	14
+#define CONFIG_DEFAULT_EMERGENCY_TICK_PERIOD	500
+#define CONFIG_DEFAULT_TARGET_TEMPERATURE		30
+#define CONFIG_DEFAULT_PID_KP					2048	/* 8.0 percent per degree */
+#define CONFIG_DEFAULT_PID_KI					32		/* 0.125 percent per degree and step */
+#define CONFIG_DEFAULT_PID_KD					512		/* 2.0 percent per degree of change per step */
+#define CONFIG_DEFAULT_BAUD_RATE				9600
+
+/* Limits of the checked fields */
+#define CONFIG_MAX_TEMPERATURE					150		/* Top of the LM35 range */
+#define CONFIG_MIN_EMERGENCY_TICK_PERIOD		100		/* ms */
+
+/*
+ * Service command used to read the configuration over the UART. The tool
+ * writes it with a LINK_CONFIG_WRITE frame. Both are answered with a
+ * LINK_CONFIG frame holding the configuration in use, which also updates the
+ * MCU listening on the same line.
+ */
+#define CONFIG_READ_CMD							0xF1
+
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+
+typedef struct {
+	uint8 version;                /* Layout version, must be CONFIG_VERSION */
+	uint8 fanStartTemperature;    /* Fan starts above this temperature */
+	uint8 fanFullTemperature;     /* Fan runs at full speed from this temperature */
+	uint8 emergencyTemperature;   /* Emergency state above this temperature */
+	uint8 emergencyTimeoutTicks;  /* Emergency ticks before the abnormal state */
+	uint16 emergencyTickPeriod;   /* Emergency tick period in ms (applied at start-up) */
+	uint8 targetTemperature;      /* Temperature held by the fan controller */
+	uint16 pidKp;                 /* Fan controller gains, Q8.8, trim the fan curve, all 0 to follow the curve alone */
+	uint16 pidKi;
+	uint16 pidKd;
+	uint32 baudRate;              /* UART baud rate (applied at start-up) */
+	uint8 checksum;               /* Makes the sum of all the bytes of the block zero */
+} Config_Type;
+
+/*******************************************************************************
+ *                              Functions Prototypes                           *
+ *******************************************************************************/
+
+/******************************************************************************
+ * Service Name: Config_init
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-reentrant
+ * Parameters (in): None
+ * Parameters (inout): None
+ * Parameters (out): None
+ * Return value: None
+ * Description: Loads the configuration block from the EEPROM into RAM. If the
+ *              stored block has another version or a wrong checksum, the
+ *              defaults are used and written back to the EEPROM.
+ *******************************************************************************/
+void Config_init(void);
+
+/******************************************************************************
+ * Service Name: Config_get
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters (in): None
+ * Parameters (inout): None
+ * Parameters (out): None
+ * Return value: const Config_Type* - The configuration held in RAM
+ * Description: Returns the RAM copy of the configuration, hot paths read it
+ *              directly instead of going to the EEPROM.
+ *******************************************************************************/
+const Config_Type* Config_get(void);
+
+/******************************************************************************
+ * Service Name: Config_update
+ * Sync/Async: Asynchronous
+ * Reentrancy: Non-reentrant
+ * Parameters (in): Config_Ptr - The new configuration block
+ * Parameters (inout): None
+ * Parameters (out): None
+ * Return value: boolean - TRUE if the block was valid and accepted
+ * Description: Checks the version, checksum, thresholds order and field ranges
+ *              of the block, then replaces the RAM copy and queues the EEPROM
+ *              write. A block equal to the one in use is not written again.
+ *******************************************************************************/
+boolean Config_update(const Config_Type *Config_Ptr);
+
+/******************************************************************************
+ * Service Name: Config_send
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-reentrant
+ * Parameters (in): None
+ * Parameters (inout): None
+ * Parameters (out): None
+ * Return value: None
+ * Description: Sends the configuration in use in a LINK_CONFIG frame.
+ *******************************************************************************/
+void Config_send(void);
+
+#endif /* CONFIG_H_ */
@@ -0,0 +1,227 @@
+ /******************************************************************************
+ *
+ * Module: Event Log
+ *
+ * File Name: event_log.c
+ *
+ * Description: Source file for the circular fault/event log kept in the internal EEPROM
+ *
+ * Author: Mohamed Hisham
+ *
+ *******************************************************************************/
+
+#include "event_log.h"
+#include "nvm_layout.h"
+#include "../MCAL/internal_EEPROM.h"
+#include "link.h"
+#include <avr/io.h>
+#include <avr/interrupt.h>
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+#define EVENT_LOG_RECORD_SIZE		LINK_EVENT_LOG_RECORD_SIZE
+
+#define EVENT_LOG_RECORD_ADDRESS(index)	\
+	(NVM_EVENT_LOG_ADDRESS + ((uint16)(index) * EVENT_LOG_RECORD_SIZE))
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+static uint8 g_nextIndex = 0;     /* Slot that receives the next record */
+static uint8 g_recordsCount = 0;  /* Number of valid records in the log */
+static uint8 g_nextSequence = 0;  /* Sequence number of the next record */
+
+/* Dump in progress, see EventLog_process */
+static boolean g_dumpStarting = FALSE; /* The start frame is still to be sent */
+static uint8 g_dumpIndex = 0;          /* Slot of the next record to send */
+static uint8 g_dumpRemaining = 0;      /* Records still to send */
+
+/* The records are sent as they are stored, MCU2 takes their size from link.h */
+typedef char EventLog_RecordSizeCheck[(sizeof(EventLog_RecordType) == LINK_EVENT_LOG_RECORD_SIZE) ? 1 : -1];
+
+/*******************************************************************************
+ *                      Private Functions Definitions                          *
+ *******************************************************************************/
+
+/* Sequence numbers roll over before reaching the erased EEPROM value */
+static uint8 EventLog_nextSequence(uint8 sequence)
+{
+	sequence++;
+	if (sequence == EVENT_LOG_EMPTY_SEQUENCE)
+	{
+		sequence = 0;
+	}
+	return sequence;
+}
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+/******************************************************************************
+ * Service Name: EventLog_init
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-reentrant
+ * Parameters (in): None
+ * Parameters (inout): None
+ * Parameters (out): None
+ * Return value: None
+ * Description: The records are written in order, so the newest one is the last
+ *              record before an erased slot or before a break in the sequence.
+ *              Only the sequence byte of each record is read.
+ *******************************************************************************/
+void EventLog_init(void)
+{
+	uint8 i;
+	uint8 sequence;
+	uint8 previousSequence = EVENT_LOG_EMPTY_SEQUENCE;
+
+	g_nextIndex = 0;
+	g_recordsCount = EVENT_LOG_CAPACITY;
+
+	for (i = 0; i < EVENT_LOG_CAPACITY; i++)
+	{
+		sequence = INTERNAL_EEPROM_readByte(EVENT_LOG_RECORD_ADDRESS(i));
+
+		if (sequence == EVENT_LOG_EMPTY_SEQUENCE)
+		{
+			/* Log was never filled, the records are in slots 0 .. i-1 */
+			g_nextIndex = i;
+			g_recordsCount = i;
+			break;
+		}
+
+		if ((i != 0) && (sequence != EventLog_nextSequence(previousSequence)))
+		{
+			/* Log has wrapped, slot i holds the oldest record */
+			g_nextIndex = i;
+			break;
+		}
+
+		previousSequence = sequence;
+	}
+
+	if (g_nextIndex == 0)
+	{
+		/* Empty log, or full log whose newest record is in the last slot */
+		previousSequence = INTERNAL_EEPROM_readByte(EVENT_LOG_RECORD_ADDRESS(EVENT_LOG_CAPACITY - 1));
+	}
+	else
+	{
+		previousSequence = INTERNAL_EEPROM_readByte(EVENT_LOG_RECORD_ADDRESS(g_nextIndex - 1));
+	}
+
+	g_nextSequence = (previousSequence == EVENT_LOG_EMPTY_SEQUENCE) ? 0 : EventLog_nextSequence(previousSequence);
+}
+
+/******************************************************************************
+ * Service Name: EventLog_record
+ * Sync/Async: Asynchronous
+ * Reentrancy: Reentrant
+ * Parameters (in): type - The event type
+ *                  timestamp - Time in ms since start-up at which the event started
+ *                  peakTemperature - Highest temperature seen during the event
+ *                  duration - Event duration in emergency ticks
+ * Parameters (inout): None
+ * Parameters (out): None
+ * Return value: boolean - TRUE if the record was queued for writing
+ * Description: The slot bookkeeping is done with interrupts disabled so records
+ *              coming from an ISR and from the main loop never share a slot.
+ *******************************************************************************/
+boolean EventLog_record(EventLog_EventType type, uint32 timestamp, uint8 peakTemperature, uint16 duration)
+{
+	EventLog_RecordType record;
+	boolean queued;
+	uint8 sreg;
+
+	record.type = type;
+	record.peakTemperature = peakTemperature;
+	record.duration = duration;
+	record.timestamp = timestamp;
+
+	sreg = SREG;
+	cli();
+
+	record.sequence = g_nextSequence;
+	queued = INTERNAL_EEPROM_writeBlockAsync(EVENT_LOG_RECORD_ADDRESS(g_nextIndex),
+			(const uint8*)&record, EVENT_LOG_RECORD_SIZE);
+
+	if (queued)
+	{
+		g_nextSequence = EventLog_nextSequence(g_nextSequence);
+		g_nextIndex = (g_nextIndex + 1) % EVENT_LOG_CAPACITY;
+		if (g_recordsCount < EVENT_LOG_CAPACITY)
+		{
+			g_recordsCount++;
+		}
+	}
+
+	SREG = sreg;
+
+	return queued;
+}
+
+/******************************************************************************
+ * Service Name: EventLog_dump
+ * Sync/Async: Asynchronous
+ * Reentrancy: Non-reentrant
+ * Parameters (in): None
+ * Parameters (inout): None
+ * Parameters (out): None
+ * Return value: None
+ * Description: Requests a dump of the log, EventLog_process sends it. A dump
+ *              already in progress is started again.
+ *******************************************************************************/
+void EventLog_dump(void)
+{
+	g_dumpStarting = TRUE;
+	g_dumpRemaining = 0;
+}
+
+/******************************************************************************
+ * Service Name: EventLog_process
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-reentrant
+ * Parameters (in): None
+ * Parameters (inout): None
+ * Parameters (out): None
+ * Return value: None
+ * Description: Sends at most one frame of the requested dump, nothing while
+ *              records are still being written to the EEPROM. The records
+ *              count and the oldest slot are taken with the start frame.
+ *******************************************************************************/
+void EventLog_process(void)
+{
+	uint8 record[EVENT_LOG_RECORD_SIZE];
+	uint16 address;
+	uint8 i;
+
+	if ((!g_dumpStarting && g_dumpRemaining == 0) || INTERNAL_EEPROM_isBusy())
+	{
+		return;
+	}
+
+	if (g_dumpStarting)
+	{
+		g_dumpStarting = FALSE;
+
+		/* The oldest record is in slot 0 until the log wraps, then in the next slot */
+		g_dumpIndex = (g_recordsCount < EVENT_LOG_CAPACITY) ? 0 : g_nextIndex;
+		g_dumpRemaining = g_recordsCount;
+		Link_sendFrame(LINK_EVENT_LOG_START, &g_dumpRemaining, 1);
+		return;
+	}
+
+	address = EVENT_LOG_RECORD_ADDRESS(g_dumpIndex);
+	for (i = 0; i < EVENT_LOG_RECORD_SIZE; i++)
+	{
+		record[i] = INTERNAL_EEPROM_readByte(address + i);
+	}
+	Link_sendFrame(LINK_EVENT_LOG_RECORD, record, EVENT_LOG_RECORD_SIZE);
+
+	g_dumpIndex = (g_dumpIndex + 1) % EVENT_LOG_CAPACITY;
+	g_dumpRemaining--;
+}
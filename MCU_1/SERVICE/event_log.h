@@ -0,0 +1,118 @@
+ /******************************************************************************
+ *
+ * Module: Event Log
+ *
+ * File Name: event_log.h
+ *
+ * Description: Header file for the circular fault/event log kept in the internal EEPROM
+ *
+ * Author: Mohamed Hisham
+ *
+ *******************************************************************************/
+
+#ifndef EVENT_LOG_H_
+#define EVENT_LOG_H_
+
+#include "..\std_types.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* Number of records kept before the oldest one is overwritten */
+#define EVENT_LOG_CAPACITY			16
+
+/* Sequence value of an erased (never written) record */
+#define EVENT_LOG_EMPTY_SEQUENCE	0xFF
+
+/* Service command that requests a dump of the log over the UART */
+#define EVENT_LOG_DUMP_CMD			0xF0
+
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+
+typedef enum {
+	EVENT_EMERGENCY = 1,        /* Emergency state left on its own, temperature went down */
+	EVENT_ABNORMAL,             /* Emergency state timed out, system reset by the watchdog */
+	EVENT_SHUTDOWN_REQUEST,     /* Shutdown button pressed in the shutdown range */
+	EVENT_EXTERNAL_RESET,       /* Started after a reset pin reset */
+	EVENT_BROWN_OUT_RESET,      /* Started after a brown-out reset */
+	EVENT_WATCHDOG_RESET,       /* Started after a watchdog reset */
+	EVENT_FAN_STALL,            /* Fan driven but not turning */
+	EVENT_FAN_OVERCURRENT,      /* Fan cut for an overcurrent, the duration holds the current in mA */
+	EVENT_FAN_JAMMED            /* Fan drawing its stall current, the duration holds the current in mA */
+} EventLog_EventType;
+
+typedef struct {
+	uint8 sequence;          /* Rolling record number, used to find the newest record */
+	uint8 type;              /* One of EventLog_EventType */
+	uint8 peakTemperature;   /* Highest temperature seen during the event */
+	uint16 duration;         /* Event duration in emergency ticks */
+	uint32 timestamp;        /* Time in ms since start-up at which the event started */
+} EventLog_RecordType;
+
+/*******************************************************************************
+ *                              Functions Prototypes                           *
+ *******************************************************************************/
+
+/******************************************************************************
+ * Service Name: EventLog_init
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-reentrant
+ * Parameters (in): None
+ * Parameters (inout): None
+ * Parameters (out): None
+ * Return value: None
+ * Description: Scans the sequence numbers stored in the EEPROM to find where the
+ *              next record has to be written. Must be called once at start-up.
+ *******************************************************************************/
+void EventLog_init(void);
+
+/******************************************************************************
+ * Service Name: EventLog_record
+ * Sync/Async: Asynchronous
+ * Reentrancy: Reentrant
+ * Parameters (in): type - The event type
+ *                  timestamp - Time in ms since start-up at which the event started
+ *                  peakTemperature - Highest temperature seen during the event
+ *                  duration - Event duration in emergency ticks
+ * Parameters (inout): None
+ * Parameters (out): None
+ * Return value: boolean - TRUE if the record was queued for writing
+ * Description: Appends a record to the log, overwriting the oldest one when the
+ *              log is full. The record goes through the non-blocking EEPROM write
+ *              path, so this can be called from the main loop or an ISR.
+ *******************************************************************************/
+boolean EventLog_record(EventLog_EventType type, uint32 timestamp, uint8 peakTemperature, uint16 duration);
+
+/******************************************************************************
+ * Service Name: EventLog_dump
+ * Sync/Async: Asynchronous
+ * Reentrancy: Non-reentrant
+ * Parameters (in): None
+ * Parameters (inout): None
+ * Parameters (out): None
+ * Return value: None
+ * Description: Requests a dump of the log over the UART, oldest record first.
+ *              It is sent by EventLog_process as link frames: a
+ *              LINK_EVENT_LOG_START frame with the records count, then one
+ *              LINK_EVENT_LOG_RECORD frame per record (the raw record, little
+ *              endian fields).
+ *******************************************************************************/
+void EventLog_dump(void);
+
+/******************************************************************************
+ * Service Name: EventLog_process
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-reentrant
+ * Parameters (in): None
+ * Parameters (inout): None
+ * Parameters (out): None
+ * Return value: None
+ * Description: Sends the next frame of a requested dump, if any. Called
+ *              periodically from a task, each call sends at most one frame.
+ *******************************************************************************/
+void EventLog_process(void);
+
+#endif /* EVENT_LOG_H_ */
@@ -0,0 +1,185 @@
+ /******************************************************************************
+ *
+ * Module: Fan Curve
+ *
+ * File Name: fan_curve.c
+ *
+ * Description: Source file for the table driven temperature to fan duty curve
+ *
+ * Author: Mohamed Hisham
+ *
+ *******************************************************************************/
+
+#include "fan_curve.h"
+#include "nvm_layout.h"
+#include "../MCAL/internal_EEPROM.h"
+#include <avr/pgmspace.h> /* To keep the table in flash */
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* Rounded duty of degree t on one segment, 0 outside of it */
+#define FAN_CURVE_SEGMENT_DUTY(t, t0, d0, t1, d1) \
+	((((t) >= (t0)) && ((t) < (t1))) ? \
+	((d0) + ((((d1) - (d0)) * ((t) - (t0)) + (((t1) - (t0)) / 2)) / ((t1) - (t0)))) : 0) +
+
+/* Duty of degree t as a constant expression, the sum of all the segments */
+#define FAN_CURVE_DUTY(t)		((uint8)(FAN_CURVE_SEGMENTS(FAN_CURVE_SEGMENT_DUTY, t) 0))
+
+/* Ten table entries from degree t */
+#define FAN_CURVE_ROW(t) \
+	FAN_CURVE_DUTY((t) + 0), FAN_CURVE_DUTY((t) + 1), FAN_CURVE_DUTY((t) + 2), \
+	FAN_CURVE_DUTY((t) + 3), FAN_CURVE_DUTY((t) + 4), FAN_CURVE_DUTY((t) + 5), \
+	FAN_CURVE_DUTY((t) + 6), FAN_CURVE_DUTY((t) + 7), FAN_CURVE_DUTY((t) + 8), \
+	FAN_CURVE_DUTY((t) + 9)
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+/* Built-in curve, one entry per degree from 0 to 150 */
+static const uint8 g_fanCurveFlash[] PROGMEM = {
+	FAN_CURVE_ROW(0),   FAN_CURVE_ROW(10),  FAN_CURVE_ROW(20),  FAN_CURVE_ROW(30),
+	FAN_CURVE_ROW(40),  FAN_CURVE_ROW(50),  FAN_CURVE_ROW(60),  FAN_CURVE_ROW(70),
+	FAN_CURVE_ROW(80),  FAN_CURVE_ROW(90),  FAN_CURVE_ROW(100), FAN_CURVE_ROW(110),
+	FAN_CURVE_ROW(120), FAN_CURVE_ROW(130), FAN_CURVE_ROW(140), FAN_CURVE_DUTY(150)
+};
+
+/* Fails to compile if the rows above do not match FAN_CURVE_MAX_TEMPERATURE */
+typedef char FanCurve_FlashSizeCheck[(sizeof(g_fanCurveFlash) == (FAN_CURVE_MAX_TEMPERATURE + 1)) ? 1 : -1];
+
+#if (FAN_CURVE_EEPROM_ENABLE == 1)
+/* Curve loaded from the EEPROM, used instead of the flash table when valid */
+static uint8 g_fanCurveRam[FAN_CURVE_MAX_TEMPERATURE + 1];
+static boolean g_fanCurveRamUsed = FALSE;
+#endif
+
+/*******************************************************************************
+ *                      Private Functions Definitions                          *
+ *******************************************************************************/
+
+#if (FAN_CURVE_EEPROM_ENABLE == 1)
+static boolean FanCurve_isValid(const FanCurve_BlockType *Block_Ptr)
+{
+	const uint8 *bytes = (const uint8*)Block_Ptr;
+	uint8 sum = 0;
+	uint8 i;
+
+	for (i = 0; i < sizeof(FanCurve_BlockType); i++)
+	{
+		sum += bytes[i];
+	}
+
+	if ((sum != 0) || (Block_Ptr->count < 2) || (Block_Ptr->count > FAN_CURVE_MAX_POINTS))
+	{
+		return FALSE;
+	}
+
+	for (i = 0; i < Block_Ptr->count; i++)
+	{
+		if (Block_Ptr->points[i].duty > 100)
+		{
+			return FALSE;
+		}
+		if ((i > 0) && (Block_Ptr->points[i].temperature <= Block_Ptr->points[i - 1].temperature))
+		{
+			return FALSE;
+		}
+	}
+
+	return TRUE;
+}
+
+/* Interpolates the points once for every degree, the divisions stay out of the lookups */
+static void FanCurve_expand(const FanCurve_BlockType *Block_Ptr)
+{
+	const FanCurve_PointType *points = Block_Ptr->points;
+	uint8 last = Block_Ptr->count - 1;
+	uint8 segment = 0;
+	uint8 t;
+
+	for (t = 0; t <= FAN_CURVE_MAX_TEMPERATURE; t++)
+	{
+		while ((segment < last) && (t >= points[segment + 1].temperature))
+		{
+			segment++;
+		}
+
+		if ((t <= points[0].temperature) || (segment == last))
+		{
+			g_fanCurveRam[t] = points[segment].duty;
+		}
+		else
+		{
+			sint16 rise = (sint16)points[segment + 1].duty - points[segment].duty;
+			uint8 run = points[segment + 1].temperature - points[segment].temperature;
+			g_fanCurveRam[t] = (uint8)(points[segment].duty +
+					((rise * (t - points[segment].temperature)) + (sint16)(run / 2)) / run);
+		}
+	}
+}
+#endif
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+/******************************************************************************
+ * Service Name: FanCurve_init
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-reentrant
+ * Parameters (in): None
+ * Parameters (inout): None
+ * Parameters (out): None
+ * Return value: boolean - TRUE if a valid curve was loaded from the EEPROM
+ * Description: Expands the curve stored in the EEPROM into a RAM table when it
+ *              is valid, otherwise the built-in flash table stays in use. An
+ *              erased EEPROM never holds a valid curve.
+ *******************************************************************************/
+boolean FanCurve_init(void)
+{
+#if (FAN_CURVE_EEPROM_ENABLE == 1)
+	FanCurve_BlockType block;
+
+	INTERNAL_EEPROM_readBlock(NVM_FAN_CURVE_ADDRESS, (uint8*)&block, sizeof(FanCurve_BlockType));
+
+	g_fanCurveRamUsed = FanCurve_isValid(&block);
+	if (g_fanCurveRamUsed)
+	{
+		FanCurve_expand(&block);
+	}
+
+	return g_fanCurveRamUsed;
+#else
+	return FALSE;
+#endif
+}
+
+/******************************************************************************
+ * Service Name: FanCurve_getDuty
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters (in): temperature - Temperature in degrees
+ * Parameters (inout): None
+ * Parameters (out): None
+ * Return value: uint8 - Fan duty in percent
+ * Description: Reads the duty of the temperature from the table in use, one
+ *              indexed load without any arithmetic.
+ *******************************************************************************/
+uint8 FanCurve_getDuty(uint8 temperature)
+{
+	if (temperature > FAN_CURVE_MAX_TEMPERATURE)
+	{
+		temperature = FAN_CURVE_MAX_TEMPERATURE;
+	}
+
+#if (FAN_CURVE_EEPROM_ENABLE == 1)
+	if (g_fanCurveRamUsed)
+	{
+		return g_fanCurveRam[temperature];
+	}
+#endif
+
+	return pgm_read_byte(&g_fanCurveFlash[temperature]);
+}
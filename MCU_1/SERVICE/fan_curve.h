@@ -0,0 +1,97 @@
+ /******************************************************************************
+ *
+ * Module: Fan Curve
+ *
+ * File Name: fan_curve.h
+ *
+ * Description: Header file for the table driven temperature to fan duty curve
+ *
+ * Author: Mohamed Hisham
+ *
+ *******************************************************************************/
+
+#ifndef FAN_CURVE_H_
+#define FAN_CURVE_H_
+
+#include "..\std_types.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* One table entry per degree from 0, higher temperatures use the last one */
+#define FAN_CURVE_MAX_TEMPERATURE	150
+
+/*
+ * Built-in curve, expanded by the compiler into the flash table. Each segment
+ * SEGMENT(t, start temperature, start duty, end temperature, end duty) runs
+ * linearly up to, but not including, the end temperature. The segments have to
+ * cover 0 to FAN_CURVE_MAX_TEMPERATURE, a degree outside all of them gets 0%.
+ * Duties are in percent. It matches the default fan start and full temperatures,
+ * quiet up to 30 degrees and steeper on the way to full speed.
+ */
+#define FAN_CURVE_SEGMENTS(SEGMENT, t) \
+	SEGMENT(t, 0,  0,   20,  0)   \
+	SEGMENT(t, 20, 0,   30,  30)  \
+	SEGMENT(t, 30, 30,  40,  100) \
+	SEGMENT(t, 40, 100, 151, 100)
+
+/*
+ * 1 to look for a curve in the EEPROM at start-up, it then replaces the
+ * built-in one. It takes FAN_CURVE_MAX_TEMPERATURE + 1 bytes of RAM.
+ */
+#define FAN_CURVE_EEPROM_ENABLE		1
+
+/* Most break points of a curve stored in the EEPROM */
+#define FAN_CURVE_MAX_POINTS		8
+
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+
+typedef struct {
+	uint8 temperature;
+	uint8 duty;                   /* Percent */
+} FanCurve_PointType;
+
+/*
+ * Curve block in the EEPROM, written with the EEPROM image. Below the first
+ * point the first duty is used, above the last point the last duty.
+ */
+typedef struct {
+	uint8 count;                  /* Points used, 2 to FAN_CURVE_MAX_POINTS */
+	FanCurve_PointType points[FAN_CURVE_MAX_POINTS]; /* Rising temperatures */
+	uint8 checksum;               /* Makes the sum of all the bytes of the block zero */
+} FanCurve_BlockType;
+
+/*******************************************************************************
+ *                              Functions Prototypes                           *
+ *******************************************************************************/
+
+/******************************************************************************
+ * Service Name: FanCurve_init
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-reentrant
+ * Parameters (in): None
+ * Parameters (inout): None
+ * Parameters (out): None
+ * Return value: boolean - TRUE if a valid curve was loaded from the EEPROM
+ * Description: Expands the curve stored in the EEPROM into a RAM table when it
+ *              is valid, otherwise the built-in flash table stays in use.
+ *******************************************************************************/
+boolean FanCurve_init(void);
+
+/******************************************************************************
+ * Service Name: FanCurve_getDuty
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters (in): temperature - Temperature in degrees
+ * Parameters (inout): None
+ * Parameters (out): None
+ * Return value: uint8 - Fan duty in percent
+ * Description: Reads the duty of the temperature from the table in use, one
+ *              indexed load without any arithmetic.
+ *******************************************************************************/
+uint8 FanCurve_getDuty(uint8 temperature);
+
+#endif /* FAN_CURVE_H_ */
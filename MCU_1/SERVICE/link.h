@@ -0,0 +1,112 @@
+ /******************************************************************************
+ *
+ * Module: Link
+ *
+ * File Name: link.h
+ *
+ * Description: Header file for the frames sent from MCU1 to MCU2, shared by
+ *              both MCUs
+ *
+ * Author: Mohamed Hisham
+ *
+ *******************************************************************************/
+
+#ifndef LINK_H_
+#define LINK_H_
+
+#include "..\std_types.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * A frame is LINK_FRAME_START, the type, the payload length, the payload and
+ * a checksum that makes the sum of the type, length, payload and checksum
+ * bytes zero. The start byte is above any temperature and is not one of the
+ * single byte codes, so outside a frame it can only mean a new frame. A frame
+ * with a lost byte fails its checksum and the receiver waits for the next
+ * start byte, so it never stays out of step with the sender. The bytes that
+ * follow a dropped frame may still belong to it, the application should not
+ * act on them until the line was quiet or a frame was received again.
+ */
+#define LINK_FRAME_START		0xF8
+
+/* Longest payload, the frames are sent in one go and kept whole by the receiver */
+#define LINK_MAX_PAYLOAD		20
+
+/* Frame types */
+#define LINK_FAN_RPM			0x01	/* Fan RPM, low byte first */
+#define LINK_EVENT_LOG_START	0x02	/* Start of an event log dump, the records count */
+#define LINK_EVENT_LOG_RECORD	0x03	/* One record of the dump, oldest first */
+#define LINK_CONFIG				0x04	/* Configuration in use, sent by MCU1 on a read or a write */
+#define LINK_CONFIG_WRITE		0x05	/* New configuration, sent by the diagnostic tool to MCU1 */
+
+/* Bytes of an event log record, the layout of EventLog_RecordType in MCU1 */
+#define LINK_EVENT_LOG_RECORD_SIZE	9
+
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+
+typedef enum {
+	LINK_NOT_FRAME,           /* The byte is not part of a frame */
+	LINK_IN_FRAME,            /* The byte was taken, the frame is not complete yet */
+	LINK_FRAME_OK,            /* The frame is complete and its checksum is right */
+	LINK_FRAME_ERROR          /* The frame was dropped, the receiver waits for a new one */
+} Link_ResultType;
+
+typedef struct {
+	uint8 state;              /* Next byte expected */
+	uint8 type;               /* Type of the frame */
+	uint8 length;             /* Payload length of the frame */
+	uint8 index;              /* Payload bytes received */
+	uint8 sum;                /* Sum of the bytes received after the start byte */
+	uint8 payload[LINK_MAX_PAYLOAD];
+} Link_ReceiverType;
+
+/*******************************************************************************
+ *                              Functions Prototypes                           *
+ *******************************************************************************/
+
+/******************************************************************************
+ * Service Name: Link_sendFrame
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-reentrant
+ * Parameters (in): type - The frame type
+ *                  payload - The payload bytes
+ *                  length - The payload length, up to LINK_MAX_PAYLOAD
+ * Parameters (inout): None
+ * Parameters (out): None
+ * Return value: None
+ * Description: Sends a frame over the UART. Called from thread context only,
+ *              so no other frame or code can be sent in its middle.
+ *******************************************************************************/
+void Link_sendFrame(uint8 type, const uint8 *payload, uint8 length);
+
+/******************************************************************************
+ * Service Name: Link_resetReceiver
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters (in): None
+ * Parameters (inout): receiver - The receiver
+ * Parameters (out): None
+ * Return value: None
+ * Description: Drops the frame being received, if any.
+ *******************************************************************************/
+void Link_resetReceiver(Link_ReceiverType *receiver);
+
+/******************************************************************************
+ * Service Name: Link_receiveByte
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters (in): data - The received byte
+ * Parameters (inout): receiver - The receiver
+ * Parameters (out): None
+ * Return value: Link_ResultType - What the byte was used for
+ * Description: Feeds one received byte to the receiver, never waits. After
+ *              LINK_FRAME_OK the frame is in the receiver until the next byte.
+ *******************************************************************************/
+Link_ResultType Link_receiveByte(Link_ReceiverType *receiver, uint8 data);
+
+#endif /* LINK_H_ */
@@ -0,0 +1,41 @@
+ /******************************************************************************
+ *
+ * Module: NVM Layout
+ *
+ * File Name: nvm_layout.h
+ *
+ * Description: Addresses of every block kept in the internal EEPROM
+ *
+ * Author: Mohamed Hisham
+ *
+ *******************************************************************************/
+
+#ifndef NVM_LAYOUT_H_
+#define NVM_LAYOUT_H_
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* Last control state of the application state machine (1 byte) */
+#define NVM_STATE_ADDRESS			0x0000
+
+/* Emergency ticks counted so far, valid while the state is the emergency state (1 byte) */
+#define NVM_EMERGENCY_TIME_ADDRESS	0x0001
+
+/* Peak temperature of the current emergency (1 byte) */
+#define NVM_EMERGENCY_PEAK_ADDRESS	0x0002
+
+/* Time in ms at which the current emergency started, in the run it started in (4 bytes) */
+#define NVM_EMERGENCY_START_ADDRESS	0x0003
+
+/* Runtime configuration block (sizeof(Config_Type) bytes) */
+#define NVM_CONFIG_ADDRESS			0x0010
+
+/* Fan curve that replaces the built-in one (sizeof(FanCurve_BlockType) bytes) */
+#define NVM_FAN_CURVE_ADDRESS		0x0028
+
+/* Circular event log (EVENT_LOG_CAPACITY records) */
+#define NVM_EVENT_LOG_ADDRESS		0x0040
+
+#endif /* NVM_LAYOUT_H_ */
@@ -0,0 +1,147 @@
+ /******************************************************************************
+ *
+ * Module: PID Controller
+ *
+ * File Name: pid.c
+ *
+ * Description: Source file for the fixed-point PID controller
+ *
+ * Author: Mohamed Hisham
+ *
+ *******************************************************************************/
+
+#include "pid.h"
+
+/*******************************************************************************
+ *                      Private Functions Definitions                          *
+ *******************************************************************************/
+
+static sint32 Pid_clamp(sint32 value, sint32 min, sint32 max)
+{
+	if (value < min)
+	{
+		return min;
+	}
+	if (value > max)
+	{
+		return max;
+	}
+	return value;
+}
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+/******************************************************************************
+ * Service Name: Pid_init
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters (in): outputMin - Lowest output
+ *                  outputMax - Highest output
+ * Parameters (inout): pid_ptr - The controller
+ * Parameters (out): None
+ * Return value: None
+ * Description: Sets the output range and resets the controller, the gains are
+ *              set with Pid_setGains.
+ *******************************************************************************/
+void Pid_init(Pid_ControllerType *pid_ptr, sint16 outputMin, sint16 outputMax)
+{
+	pid_ptr->kp = 0;
+	pid_ptr->ki = 0;
+	pid_ptr->kd = 0;
+	pid_ptr->outputMin = outputMin;
+	pid_ptr->outputMax = outputMax;
+	Pid_reset(pid_ptr);
+}
+
+/******************************************************************************
+ * Service Name: Pid_setGains
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters (in): kp - Proportional gain, Q8.8
+ *                  ki - Integral gain per step, Q8.8
+ *                  kd - Derivative gain per step, Q8.8
+ * Parameters (inout): pid_ptr - The controller
+ * Parameters (out): None
+ * Return value: None
+ * Description: Changes the gains, can be called while the controller runs.
+ *******************************************************************************/
+void Pid_setGains(Pid_ControllerType *pid_ptr, uint16 kp, uint16 ki, uint16 kd)
+{
+	pid_ptr->kp = kp;
+	pid_ptr->ki = ki;
+	pid_ptr->kd = kd;
+}
+
+/******************************************************************************
+ * Service Name: Pid_reset
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters (in): None
+ * Parameters (inout): pid_ptr - The controller
+ * Parameters (out): None
+ * Return value: None
+ * Description: Clears the integral term and the measurement history, to be
+ *              called before the controller takes over again.
+ *******************************************************************************/
+void Pid_reset(Pid_ControllerType *pid_ptr)
+{
+	pid_ptr->integral = 0;
+	pid_ptr->lastMeasurement = 0;
+	pid_ptr->started = FALSE;
+}
+
+/******************************************************************************
+ * Service Name: Pid_step
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters (in): setpoint - The value to hold
+ *                  measurement - The measured value
+ *                  feedForward - Output expected for the measurement, 0 for none
+ * Parameters (inout): pid_ptr - The controller
+ * Parameters (out): None
+ * Return value: sint16 - The new output, within the output range
+ * Description: All the terms are summed in Q8.8 and rounded once at the end.
+ *              The derivative is taken on the measurement, so a setpoint change
+ *              gives no kick. The integral is kept within what the output range
+ *              leaves around the feed-forward and does not grow while the
+ *              output is saturated in the direction of the error (anti-windup).
+ *******************************************************************************/
+sint16 Pid_step(Pid_ControllerType *pid_ptr, sint16 setpoint, sint16 measurement, sint16 feedForward)
+{
+	sint32 min = (sint32)pid_ptr->outputMin << PID_GAIN_SHIFT;
+	sint32 max = (sint32)pid_ptr->outputMax << PID_GAIN_SHIFT;
+	sint32 feed = (sint32)feedForward << PID_GAIN_SHIFT;
+	sint16 error = measurement - setpoint;
+	sint32 proportional;
+	sint32 derivative = 0;
+	sint32 integral;
+	sint32 output;
+
+	if (pid_ptr->started)
+	{
+		derivative = (sint32)pid_ptr->kd * (sint16)(measurement - pid_ptr->lastMeasurement);
+	}
+	pid_ptr->lastMeasurement = measurement;
+	pid_ptr->started = TRUE;
+
+	proportional = (sint32)pid_ptr->kp * error;
+	integral = Pid_clamp(pid_ptr->integral + ((sint32)pid_ptr->ki * error), min - feed, max - feed);
+
+	output = feed + proportional + integral + derivative;
+
+	/* Keep the new integral only if it does not push a saturated output further */
+	if (!((output > max) && (error > 0)) && !((output < min) && (error < 0)))
+	{
+		pid_ptr->integral = integral;
+	}
+	else
+	{
+		output = feed + proportional + pid_ptr->integral + derivative;
+	}
+
+	output = Pid_clamp(output, min, max);
+
+	return (sint16)((output + (PID_GAIN_ONE / 2)) >> PID_GAIN_SHIFT);
+}
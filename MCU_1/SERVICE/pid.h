@@ -0,0 +1,104 @@
+ /******************************************************************************
+ *
+ * Module: PID Controller
+ *
+ * File Name: pid.h
+ *
+ * Description: Header file for the fixed-point PID controller
+ *
+ * Author: Mohamed Hisham
+ *
+ *******************************************************************************/
+
+#ifndef PID_H_
+#define PID_H_
+
+#include "..\std_types.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* The gains are Q8.8 fixed-point numbers, 256 is a gain of 1 */
+#define PID_GAIN_SHIFT		8
+#define PID_GAIN_ONE		(1 << PID_GAIN_SHIFT)
+
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+
+typedef struct {
+	uint16 kp;                /* Proportional gain, Q8.8 */
+	uint16 ki;                /* Integral gain per step, Q8.8 */
+	uint16 kd;                /* Derivative gain per step, Q8.8 */
+	sint16 outputMin;
+	sint16 outputMax;
+	sint32 integral;          /* Integral term, Q8.8 output units */
+	sint16 lastMeasurement;   /* Measurement of the previous step */
+	boolean started;          /* FALSE until the first step */
+} Pid_ControllerType;
+
+/*******************************************************************************
+ *                              Functions Prototypes                           *
+ *******************************************************************************/
+
+/******************************************************************************
+ * Service Name: Pid_init
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters (in): outputMin - Lowest output
+ *                  outputMax - Highest output
+ * Parameters (inout): pid_ptr - The controller
+ * Parameters (out): None
+ * Return value: None
+ * Description: Sets the output range and resets the controller, the gains are
+ *              set with Pid_setGains.
+ *******************************************************************************/
+void Pid_init(Pid_ControllerType *pid_ptr, sint16 outputMin, sint16 outputMax);
+
+/******************************************************************************
+ * Service Name: Pid_setGains
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters (in): kp - Proportional gain, Q8.8
+ *                  ki - Integral gain per step, Q8.8
+ *                  kd - Derivative gain per step, Q8.8
+ * Parameters (inout): pid_ptr - The controller
+ * Parameters (out): None
+ * Return value: None
+ * Description: Changes the gains, can be called while the controller runs.
+ *******************************************************************************/
+void Pid_setGains(Pid_ControllerType *pid_ptr, uint16 kp, uint16 ki, uint16 kd);
+
+/******************************************************************************
+ * Service Name: Pid_reset
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters (in): None
+ * Parameters (inout): pid_ptr - The controller
+ * Parameters (out): None
+ * Return value: None
+ * Description: Clears the integral term and the measurement history, to be
+ *              called before the controller takes over again.
+ *******************************************************************************/
+void Pid_reset(Pid_ControllerType *pid_ptr);
+
+/******************************************************************************
+ * Service Name: Pid_step
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters (in): setpoint - The value to hold
+ *                  measurement - The measured value
+ *                  feedForward - Output expected for the measurement, 0 for none
+ * Parameters (inout): pid_ptr - The controller
+ * Parameters (out): None
+ * Return value: sint16 - The new output, within the output range
+ * Description: Runs one step of the controller, to be called at a fixed rate.
+ *              The controller is reverse acting, as a cooler needs: the output
+ *              rises while the measurement is above the setpoint. The terms
+ *              trim the feed-forward, with all the gains at 0 the output is
+ *              the feed-forward.
+ *******************************************************************************/
+sint16 Pid_step(Pid_ControllerType *pid_ptr, sint16 setpoint, sint16 measurement, sint16 feedForward);
+
+#endif /* PID_H_ */
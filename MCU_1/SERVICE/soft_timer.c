@@ -0,0 +1,325 @@
+ /******************************************************************************
+ *
+ * Module: Software Timers
+ *
+ * File Name: soft_timer.c
+ *
+ * Description: Source file for the software timers driven by the system tick
+ *
+ * Author: Mohamed Hisham
+ *
+ *******************************************************************************/
+
+#include "soft_timer.h"
+#include "timebase.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+#define SOFT_TIMER_WHEEL_MASK		(SOFT_TIMER_WHEEL_SIZE - 1)
+
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+
+typedef enum {
+	SOFT_TIMER_FREE, SOFT_TIMER_STOPPED, SOFT_TIMER_RUNNING, SOFT_TIMER_EXPIRED
+} SoftTimer_StateType;
+
+typedef struct {
+	SoftTimer_CallbackType callback;
+	uint16 period;       /* Period in ticks, 0 for a one-shot timer */
+	uint16 rounds;       /* Full turns of the wheel left before the expiry */
+	uint8 slot;          /* Wheel slot holding the timer */
+	uint8 next;          /* Next timer of the same slot */
+	uint8 prev;          /* Previous timer of the same slot */
+	uint8 state;
+} SoftTimer_ControlType;
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+static SoftTimer_ControlType g_timers[SOFT_TIMER_MAX_TIMERS];
+
+/* Each slot lists the timers expiring at a tick equal to the slot modulo the wheel size */
+static uint8 g_wheel[SOFT_TIMER_WHEEL_SIZE];
+
+/* Last tick handled by SoftTimer_process */
+static uint16 g_wheelTick = 0;
+
+/*******************************************************************************
+ *                      Private Functions Definitions                          *
+ *******************************************************************************/
+
+/* Rounds up so a timer never expires before the requested time */
+static uint16 SoftTimer_msToTicks(uint16 time)
+{
+	uint16 ticks = (uint16)((((uint32)time * 1000) + TIME_TICK_US - 1) / TIME_TICK_US);
+
+	return (ticks == 0) ? 1 : ticks;
+}
+
+/*
+ * Links the timer at the head of the slot of its expiry tick. The rounds are
+ * counted from the last handled tick, so a wheel running late does not make
+ * the timer expire early.
+ */
+static void SoftTimer_insert(uint8 id, uint16 expiry)
+{
+	SoftTimer_ControlType *timer_ptr = &g_timers[id];
+	uint8 slot = (uint8)(expiry & SOFT_TIMER_WHEEL_MASK);
+
+	timer_ptr->rounds = (uint16)(expiry - g_wheelTick - 1) / SOFT_TIMER_WHEEL_SIZE;
+	timer_ptr->slot = slot;
+	timer_ptr->prev = SOFT_TIMER_INVALID;
+	timer_ptr->next = g_wheel[slot];
+	if (g_wheel[slot] != SOFT_TIMER_INVALID)
+	{
+		g_timers[g_wheel[slot]].prev = id;
+	}
+	g_wheel[slot] = id;
+	timer_ptr->state = SOFT_TIMER_RUNNING;
+}
+
+static void SoftTimer_unlink(uint8 id)
+{
+	SoftTimer_ControlType *timer_ptr = &g_timers[id];
+
+	if (timer_ptr->prev != SOFT_TIMER_INVALID)
+	{
+		g_timers[timer_ptr->prev].next = timer_ptr->next;
+	}
+	else
+	{
+		g_wheel[timer_ptr->slot] = timer_ptr->next;
+	}
+
+	if (timer_ptr->next != SOFT_TIMER_INVALID)
+	{
+		g_timers[timer_ptr->next].prev = timer_ptr->prev;
+	}
+}
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+/******************************************************************************
+ * Service Name: SoftTimer_init
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-reentrant
+ * Parameters (in): None
+ * Parameters (inout): None
+ * Parameters (out): None
+ * Return value: None
+ * Description: Empties the timing wheel and starts it at the current tick.
+ *******************************************************************************/
+void SoftTimer_init(void)
+{
+	uint8 i;
+
+	for (i = 0; i < SOFT_TIMER_WHEEL_SIZE; i++)
+	{
+		g_wheel[i] = SOFT_TIMER_INVALID;
+	}
+
+	g_wheelTick = Time_nowTicks();
+}
+
+/******************************************************************************
+ * Service Name: SoftTimer_create
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-reentrant
+ * Parameters (in): callback - Function called each time the timer expires
+ * Parameters (inout): None
+ * Parameters (out): None
+ * Return value: uint8 - Timer ID, SOFT_TIMER_INVALID if there is no free timer
+ * Description: Takes the first free timer of the pool.
+ *******************************************************************************/
+uint8 SoftTimer_create(SoftTimer_CallbackType callback)
+{
+	uint8 id;
+
+	if (callback == NULL_PTR)
+	{
+		return SOFT_TIMER_INVALID;
+	}
+
+	for (id = 0; id < SOFT_TIMER_MAX_TIMERS; id++)
+	{
+		if (g_timers[id].state == SOFT_TIMER_FREE)
+		{
+			g_timers[id].callback = callback;
+			g_timers[id].state = SOFT_TIMER_STOPPED;
+			return id;
+		}
+	}
+
+	return SOFT_TIMER_INVALID;
+}
+
+/******************************************************************************
+ * Service Name: SoftTimer_start
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-reentrant
+ * Parameters (in): id - Timer ID returned by SoftTimer_create
+ *                  timeout - Time before the first expiry in milliseconds
+ *                  period - Time between the next expiries in milliseconds,
+ *                           0 for a one-shot timer
+ * Parameters (inout): None
+ * Parameters (out): None
+ * Return value: None
+ * Description: Unlinks the timer if it is running and links it into the slot
+ *              of its expiry tick, no list is searched.
+ *******************************************************************************/
+void SoftTimer_start(uint8 id, uint16 timeout, uint16 period)
+{
+	if ((id >= SOFT_TIMER_MAX_TIMERS) || (g_timers[id].state == SOFT_TIMER_FREE))
+	{
+		return;
+	}
+
+	if (g_timers[id].state == SOFT_TIMER_RUNNING)
+	{
+		SoftTimer_unlink(id);
+	}
+
+	g_timers[id].period = (period == 0) ? 0 : SoftTimer_msToTicks(period);
+	SoftTimer_insert(id, Time_nowTicks() + SoftTimer_msToTicks(timeout));
+}
+
+/******************************************************************************
+ * Service Name: SoftTimer_stop
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-reentrant
+ * Parameters (in): id - Timer ID returned by SoftTimer_create
+ * Parameters (inout): None
+ * Parameters (out): None
+ * Return value: None
+ * Description: Unlinks the timer from its slot. An expired timer whose callback
+ *              has not run yet is stopped too.
+ *******************************************************************************/
+void SoftTimer_stop(uint8 id)
+{
+	if ((id >= SOFT_TIMER_MAX_TIMERS) || (g_timers[id].state == SOFT_TIMER_FREE))
+	{
+		return;
+	}
+
+	if (g_timers[id].state == SOFT_TIMER_RUNNING)
+	{
+		SoftTimer_unlink(id);
+	}
+
+	g_timers[id].state = SOFT_TIMER_STOPPED;
+}
+
+/******************************************************************************
+ * Service Name: SoftTimer_isRunning
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters (in): id - Timer ID returned by SoftTimer_create
+ * Parameters (inout): None
+ * Parameters (out): None
+ * Return value: boolean - TRUE if the timer is armed
+ * Description: Tells if the timer is armed. A one-shot timer stops once it
+ *              has expired.
+ *******************************************************************************/
+boolean SoftTimer_isRunning(uint8 id)
+{
+	if (id >= SOFT_TIMER_MAX_TIMERS)
+	{
+		return FALSE;
+	}
+
+	return (g_timers[id].state == SOFT_TIMER_RUNNING) ? TRUE : FALSE;
+}
+
+/******************************************************************************
+ * Service Name: SoftTimer_isPending
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters (in): None
+ * Parameters (inout): None
+ * Parameters (out): None
+ * Return value: boolean - TRUE if ticks are waiting for SoftTimer_process
+ * Description: Compares the last handled tick with the time base.
+ *******************************************************************************/
+boolean SoftTimer_isPending(void)
+{
+	return (g_wheelTick != Time_nowTicks()) ? TRUE : FALSE;
+}
+
+/******************************************************************************
+ * Service Name: SoftTimer_process
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-reentrant
+ * Parameters (in): None
+ * Parameters (inout): None
+ * Parameters (out): None
+ * Return value: None
+ * Description: For each new tick only the slot of that tick is visited. The
+ *              expired timers are collected first and their callbacks called
+ *              after the walk, so a callback can start or stop any timer. The
+ *              tick interrupt itself never touches the wheel.
+ *******************************************************************************/
+void SoftTimer_process(void)
+{
+	SoftTimer_ControlType *timer_ptr;
+	uint8 expired[SOFT_TIMER_MAX_TIMERS];
+	uint8 expiredCount;
+	uint8 id;
+	uint8 next;
+	uint8 i;
+
+	while (g_wheelTick != Time_nowTicks())
+	{
+		g_wheelTick++;
+		expiredCount = 0;
+
+		id = g_wheel[g_wheelTick & SOFT_TIMER_WHEEL_MASK];
+		while (id != SOFT_TIMER_INVALID)
+		{
+			timer_ptr = &g_timers[id];
+			next = timer_ptr->next;
+
+			if (timer_ptr->rounds == 0)
+			{
+				SoftTimer_unlink(id);
+				timer_ptr->state = SOFT_TIMER_EXPIRED;
+				expired[expiredCount++] = id;
+			}
+			else
+			{
+				timer_ptr->rounds--;
+			}
+
+			id = next;
+		}
+
+		for (i = 0; i < expiredCount; i++)
+		{
+			timer_ptr = &g_timers[expired[i]];
+
+			/* Skip the timers stopped or restarted by an earlier callback */
+			if (timer_ptr->state != SOFT_TIMER_EXPIRED)
+			{
+				continue;
+			}
+
+			if (timer_ptr->period != 0)
+			{
+				/* Re-armed from the expiry tick, so the period does not drift */
+				SoftTimer_insert(expired[i], g_wheelTick + timer_ptr->period);
+			}
+			else
+			{
+				timer_ptr->state = SOFT_TIMER_STOPPED;
+			}
+
+			timer_ptr->callback();
+		}
+	}
+}
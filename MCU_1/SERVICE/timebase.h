@@ -0,0 +1,90 @@
+ /******************************************************************************
+ *
+ * Module: Time Base
+ *
+ * File Name: timebase.h
+ *
+ * Description: Header file for the monotonic system time base
+ *
+ * Author: Mohamed Hisham
+ *
+ *******************************************************************************/
+
+#ifndef TIMEBASE_H_
+#define TIMEBASE_H_
+
+#include "..\std_types.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* Timer2 runs at F_CPU/32, one count every 32us at 1MHz */
+#define TIME_COUNT_US		32
+
+/* Tick period in microseconds: one Timer2 overflow, 256 counts */
+#define TIME_TICK_US		(256UL * TIME_COUNT_US)
+
+/*
+ * Elapsed time between two readings of the same clock. The unsigned
+ * subtraction stays right across the 32-bit wrap around.
+ */
+#define TIME_ELAPSED(now, since)	((uint32)((uint32)(now) - (uint32)(since)))
+
+/*******************************************************************************
+ *                              Functions Prototypes                           *
+ *******************************************************************************/
+
+/******************************************************************************
+ * Service Name: Time_init
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-reentrant
+ * Parameters (in): None
+ * Parameters (inout): None
+ * Parameters (out): None
+ * Return value: None
+ * Description: Starts Timer2 as a free running counter, its overflow interrupt
+ *              advances the time every TIME_TICK_US.
+ *******************************************************************************/
+void Time_init(void);
+
+/******************************************************************************
+ * Service Name: Time_nowMs
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters (in): None
+ * Parameters (inout): None
+ * Parameters (out): None
+ * Return value: uint32 - Milliseconds since Time_init
+ * Description: Returns the millisecond clock, read to TIME_COUNT_US between
+ *              the ticks. It wraps around after about 49 days.
+ *******************************************************************************/
+uint32 Time_nowMs(void);
+
+/******************************************************************************
+ * Service Name: Time_nowUs
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters (in): None
+ * Parameters (inout): None
+ * Parameters (out): None
+ * Return value: uint32 - Microseconds since Time_init
+ * Description: Returns the microsecond clock with TIME_COUNT_US resolution, it
+ *              wraps around after about 71 minutes.
+ *******************************************************************************/
+uint32 Time_nowUs(void);
+
+/******************************************************************************
+ * Service Name: Time_nowTicks
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters (in): None
+ * Parameters (inout): None
+ * Parameters (out): None
+ * Return value: uint16 - Ticks since Time_init
+ * Description: Returns the raw tick count, one count every TIME_TICK_US. It
+ *              wraps around after about 9 minutes.
+ *******************************************************************************/
+uint16 Time_nowTicks(void);
+
+#endif /* TIMEBASE_H_ */
@@ -10,7 +10,7 @@
  *
  *******************************************************************************/
 #include <avr/io.h>
-#include <avr/delay.h>
+#include <avr/pgmspace.h>
 #include "..\common_macros.h"
 #include "..\MCAL\gpio.h"
 #include "..\MCAL\uart.h"
@@ -18,8 +18,16 @@
 #include "..\MCAL\adc.h"
 #include "..\HAL\led.h"
 #include "..\HAL\buzzer.h"
+#include "..\HAL\servo_mux.h"
 #include "..\HAL\servo_motor.h"
 #include "..\MCAL\timer1.h"
+#include "..\SERVICE\config.h"
+#include "..\SERVICE\scheduler.h"
+#include "..\SERVICE\timebase.h"
+#include "..\SERVICE\sequencer.h"
+#include "..\SERVICE\band.h"
+#include "..\SERVICE\link.h"
+#include "..\MCAL\profile.h"
 
 /*******************************************************************************
  *                                Definitions                                  *
@@ -35,6 +43,334 @@
 #define SHUTDOWN_CODE 0xFF
 #define ABNORMAL_CODE 0xFE
 
+/* Receive parser states, see handleByte */
+#define RX_IDLE					0		/* Waiting for a temperature, a code or the start of a frame */
+#define RX_DISCARD				1		/* A link frame was dropped, only frames are taken until the line is quiet */
+
+/* Time in ms allowed between two bytes of a frame, the parser then waits for a new one */
+#define RX_FRAME_TIMEOUT		100
+
+/* Motor duty ramp, limits the inrush current: 0 to full speed in about half a second */
+#define MOTOR_RAMP_STEP			4		/* Permille per Timer0 PWM period (2ms) */
+
+/* Motor compensation, the motor does not turn below about 25% duty */
+#define MOTOR_MIN_DUTY			250		/* Permille, lowest duty of a non zero speed */
+#define MOTOR_KICK_DUTY			600		/* Permille given from standstill */
+#define MOTOR_KICK_TICKS		50		/* Timer0 PWM periods, about 100ms */
+
+/* Motor handles, the index in motorConfig */
+#define MOTOR					0
+
+/* Temperature bands shown on the LEDs and the buzzer, see updateTemperatureBands */
+#define BAND_GREEN				0		/* Below the fan start temperature */
+#define BAND_YELLOW				1		/* Fan start temperature up to the fan full temperature */
+#define BAND_RED				2		/* Fan full temperature up to the emergency temperature */
+#define BAND_EMERGENCY			3		/* Above the emergency temperature, the buzzer is on */
+#define BAND_THRESHOLDS			3
+#define BAND_HYSTERESIS			2		/* Degrees below a threshold to leave its band */
+#define BAND_DWELL_TIME			1000	/* ms the temperature has to stay in a new band */
+#define BAND_EMERGENCY_DWELL_TIME	300	/* Shorter, the emergency must not wait long, as in MCU1 */
+
+/* Task periods and first release offsets in milliseconds */
+#define RECEIVE_TASK_PERIOD		20		/* 50Hz */
+#define MOTOR_TASK_PERIOD		100		/* 10Hz */
+#define RECEIVE_TASK_OFFSET		0
+#define MOTOR_TASK_OFFSET		10
+
+/* Servo multiplexer channels, the index in servoChannels */
+#define SHUTTER_SERVO			0
+
+/* Radiator shutter servo, 90 degrees take about 460ms with this profile */
+#define SERVO_CLOSED_ANGLE		0
+#define SERVO_OPEN_ANGLE		90
+#define SERVO_MAX_SPEED			360		/* deg/s */
+#define SERVO_ACCELERATION		1440	/* deg/s² */
+
+/* Alarm timeline of the abnormal state, 5 seconds in total */
+#define ALARM_SERVO_TRAVEL_TIME	500		/* Servo reaching 90 degrees */
+#define ALARM_BEEP_TIME			250		/* Buzzer on or off time of the pattern */
+#define ALARM_BEEP_TOGGLES		16		/* Even, so the pattern ends with the buzzer off */
+#define ALARM_HOLD_TIME			500
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+uint8 state = NORMAL_STATE;   /* Current system state */
+const Config_Type *config;    /* Runtime configuration loaded from EEPROM */
+boolean buzzerOn = FALSE;     /* Buzzer state of the alarm pattern */
+uint16 fanRpm = 0;            /* Fan speed measured by MCU1 */
+Band_ThresholdType temperatureThresholds[BAND_THRESHOLDS]; /* Taken from the configuration */
+Band_ClassifierType temperatureBand; /* Band of the received temperature */
+uint8 rxState = RX_IDLE;      /* Receive parser state */
+uint32 rxLastTime;            /* Time in ms of the task run that took the last byte */
+Link_ReceiverType link;       /* Frames of the link, see link.h */
+
+/* Servo pulse in Timer1 counts (8us) for 0, 10 ... 180 degrees, measured on the shutter servo */
+const uint16 servoCalibration[SERVO_CALIBRATION_POINTS] PROGMEM = {
+	124, 131, 138, 145, 152, 159, 166, 173, 180, 187, 194, 201, 208, 215, 222, 229, 236, 243, 250
+};
+
+/* Servo pulses generated by the servo multiplexer, kept in flash */
+const ServoMux_ChannelType servoChannels[] PROGMEM = {
+	{PORTD_ID, PIN5_ID, 124}   /* Radiator shutter, closed */
+};
+
+/* Motors driven by this MCU, kept in flash */
+const DcMotor_ConfigType motorConfig[] PROGMEM = {
+	{PORTB_ID, PIN1_ID, PORTB_ID, PIN2_ID, DC_MOTOR_PWM_TIMER0, 0, MOTOR_RAMP_STEP,
+	 MOTOR_MIN_DUTY, MOTOR_KICK_DUTY, MOTOR_KICK_TICKS, NULL_PTR} /* Timer1 is the servo's, linear motor */
+};
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * Description:
+ * Set the band thresholds from the configuration in use, the emergency band
+ * starts above the emergency temperature. The emergency threshold has MCU1's
+ * shorter dwell, so the alarm starts with MCU1's emergency state.
+ * Inputs: None
+ * Return: None
+ */
+void updateTemperatureBands(void) {
+	uint8 i;
+
+	temperatureThresholds[0].threshold = config->fanStartTemperature;
+	temperatureThresholds[1].threshold = config->fanFullTemperature;
+	temperatureThresholds[2].threshold = config->emergencyTemperature + 1;
+	for (i = 0; i < BAND_THRESHOLDS; i++) {
+		temperatureThresholds[i].hysteresis = BAND_HYSTERESIS;
+		temperatureThresholds[i].dwellMs = BAND_DWELL_TIME;
+	}
+	temperatureThresholds[2].dwellMs = BAND_EMERGENCY_DWELL_TIME;
+}
+
+/*
+ * Description:
+ * Alarm step: stop the motor and open the servo.
+ * Inputs: None
+ * Return: None
+ */
+void alarmOpen(void) {
+	DcMotor_Rotate(MOTOR, COAST, 0);
+	ServoMotor_rotate(SERVO_OPEN_ANGLE);
+}
+
+/*
+ * Description:
+ * Alarm step: only the red LED on.
+ * Inputs: None
+ * Return: None
+ */
+void alarmLedRed(void) {
+	LED_setPattern(LED_PATTERN_RED);
+}
+
+/*
+ * Description:
+ * Alarm step: toggle the buzzer, repeated to make the beep pattern.
+ * Inputs: None
+ * Return: None
+ */
+void alarmBeep(void) {
+	buzzerOn = !buzzerOn;
+	if (buzzerOn) {
+		Buzzer_on();
+	}
+	else {
+		Buzzer_off();
+	}
+}
+
+/*
+ * Description:
+ * Alarm step: close the servo.
+ * Inputs: None
+ * Return: None
+ */
+void alarmClose(void) {
+	Buzzer_off();
+	buzzerOn = FALSE;
+	ServoMotor_rotate(SERVO_CLOSED_ANGLE);
+}
+
+/*
+ * Description:
+ * Called at the end of the alarm sequence, back to normal unless a shutdown
+ * was received meanwhile.
+ * Inputs: None
+ * Return: None
+ */
+void alarmDone(void) {
+	if (state == ABNORMAL_STATE) {
+		state = NORMAL_STATE;
+	}
+}
+
+/* Abnormal state actions, run by the sequencer while the UART keeps being received */
+const Sequencer_StepType alarmSequence[] = {
+	{alarmOpen,   ALARM_SERVO_TRAVEL_TIME, 1},
+	{alarmLedRed, 0,                       1},
+	{alarmBeep,   ALARM_BEEP_TIME,         ALARM_BEEP_TOGGLES},
+	{NULL_PTR,    ALARM_HOLD_TIME,         1},
+	{alarmClose,  0,                       1}
+};
+
+/*
+ * Description:
+ * Act on a link frame received with a right checksum.
+ * Inputs: None
+ * Return: None
+ */
+void handleLinkFrame(void) {
+	switch (link.type) {
+	case LINK_FAN_RPM:
+		/* Fan speed from MCU1 telemetry */
+		if (link.length == 2) {
+			fanRpm = link.payload[0] | ((uint16)link.payload[1] << 8);
+		}
+		break;
+
+	case LINK_CONFIG:
+		/* Configuration in use in MCU1, use it here as well */
+		if ((link.length == sizeof(Config_Type)) && Config_update((const Config_Type*)link.payload)) {
+			updateTemperatureBands();
+		}
+		break;
+
+	default:
+		/* Event log dump, for the diagnostic tool */
+		break;
+	}
+}
+
+/*
+ * Description:
+ * Act on one byte received from MCU1: a temperature, a special code or a byte
+ * of a link frame. Never waits for the next byte, the bytes of a frame are
+ * collected across the runs of the task.
+ * Inputs: temperature - the received byte
+ * Return: None
+ */
+void handleByte(uint8 temperature) {
+	uint8 band;
+
+	/* Link frames, a dropped frame may leave bytes that look like codes */
+	switch (Link_receiveByte(&link, temperature)) {
+	case LINK_NOT_FRAME:
+		if (rxState == RX_DISCARD) {
+			return;
+		}
+		break;
+	case LINK_FRAME_OK:
+		rxState = RX_IDLE;
+		handleLinkFrame();
+		return;
+	case LINK_FRAME_ERROR:
+		rxState = RX_DISCARD;
+		return;
+	default:
+		return;
+	}
+
+	/* Handle different states based on the received temperature value */
+	switch (temperature) {
+	case SHUTDOWN_CODE:
+		/* Transition to SHUTDOWN state, brake the motor now instead of waiting for the motor task */
+		state = SHUTDOWN_STATE;
+		DcMotor_Rotate(MOTOR, BRAKE, 0);
+		break;
+
+	case ABNORMAL_CODE:
+		/* Handle abnormal state with specific actions, without blocking the receive path */
+		if (state != SHUTDOWN_STATE) {
+			state = ABNORMAL_STATE;
+		}
+		buzzerOn = FALSE;
+		Sequencer_start(alarmSequence, sizeof(alarmSequence) / sizeof(alarmSequence[0]), alarmDone);
+		break;
+
+	default:
+		/* Keep following the temperature, the alarm may end at any time */
+		band = Band_update(&temperatureBand, temperature);
+
+		/* The alarm sequence owns the LEDs and the buzzer while it runs */
+		if (Sequencer_isRunning()) {
+			break;
+		}
+
+		/* Normal State: set LEDs and buzzer based on the temperature band */
+		if (band == BAND_GREEN) {
+			LED_setPattern(LED_PATTERN_GREEN);
+			Buzzer_off();
+		}
+		else if (band == BAND_YELLOW) {
+			LED_setPattern(LED_PATTERN_YELLOW);
+			Buzzer_off();
+		}
+		else if (band == BAND_RED) {
+			LED_setPattern(LED_PATTERN_RED);
+			Buzzer_off();
+		}
+		else {
+			LED_setPattern(LED_PATTERN_RED);
+			Buzzer_on();
+		}
+		break;
+	}
+}
+
+/*
+ * Description:
+ * 50Hz task, handles every byte the UART interrupt buffered since the last
+ * run. A frame cut short by a lost byte is dropped after RX_FRAME_TIMEOUT,
+ * MCU1 is quiet for most of its telemetry period. The bytes are stamped with
+ * the time of the run that takes them, up to one task period after they
+ * arrived, which RX_FRAME_TIMEOUT leaves room for.
+ * Inputs: None
+ * Return: None
+ */
+void receiveTask(void) {
+	uint8 temperature;
+	uint32 now = Time_nowMs();
+
+	if (TIME_ELAPSED(now, rxLastTime) > RX_FRAME_TIMEOUT) {
+		rxState = RX_IDLE;
+		Link_resetReceiver(&link);
+	}
+
+	/* Receive the temperature value via UART */
+	while (UART_tryReceiveByte(&temperature)) {
+		handleByte(temperature);
+		rxLastTime = now;
+	}
+}
+
+/*
+ * Description:
+ * 10Hz task, drives the motor from the potentiometer unless the system is shut down.
+ * Inputs: None
+ * Return: None
+ */
+void motorTask(void) {
+	uint32 mvop;
+	uint8 motorSpeed;
+
+	/* Read the potentiometer value using ADC from channel and calculate motor speed */
+	mvop = ADC_readChannel(PIN4_ID);
+	motorSpeed = (mvop * 100) / 1023;
+
+	/* Control motor based on the current state */
+	if (state == SHUTDOWN_STATE) {
+		DcMotor_Rotate(MOTOR, BRAKE, 0);
+	}
+	else if (state == NORMAL_STATE) {
+		DcMotor_Rotate(MOTOR, FORWARD, motorSpeed);
+	}
+}
+
 /*******************************************************************************
  *                                    Main                                     *
  *******************************************************************************/
@@ -43,93 +379,47 @@ int main(void) {
 	/* Enable global interrupts */
 	SREG |= (1<<7);
 
+	/* Start the system time base */
+	Time_init();
+
+	/* Load the runtime configuration from EEPROM */
+	Config_init();
+	config = Config_get();
+	updateTemperatureBands();
+	Band_init(&temperatureBand, temperatureThresholds, BAND_THRESHOLDS);
+
 	/* Initialize various hardware modules */
 	Buzzer_init();
-	DcMotor_Init();
-	ServoMotor_init();
+	DcMotor_Init(motorConfig, sizeof(motorConfig) / sizeof(motorConfig[0]));
 	LED_init();
 	ADC_init();
 
+	/* Start the servo pulses, then configure the shutter servo and its motion profile */
+	ServoMux_init(servoChannels, sizeof(servoChannels) / sizeof(servoChannels[0]));
+	ServoMotor_ConfigType servo_config;
+	servo_config.channel = SHUTTER_SERVO;
+	servo_config.calibration = servoCalibration;
+	servo_config.maxSpeed = SERVO_MAX_SPEED;
+	servo_config.acceleration = SERVO_ACCELERATION;
+	ServoMotor_init(&servo_config);
+
 	/* Configure UART settings */
 	UART_ConfigType uart_config;
-	uart_config.baud_rate = 9600;
+	uart_config.baud_rate = config->baudRate;
 	uart_config.bit_data = BITS_8;
 	uart_config.parity = NO_PARITY;
 	uart_config.stop_bit = STOP_BIT_1;
 	UART_init(&uart_config);
 
-	/* Declare variables for temperature,
-	 * ADC output, motor speed, and system
-	 * state
-	 *  */
-	uint8 temperature;
-	uint32 mvop;
-	uint8 motorSpeed;
-	uint8 state = NORMAL_STATE;
+	/* Register the tasks, highest priority first, and run them forever */
+	Scheduler_init();
+	Sequencer_init();
+	Scheduler_addTask(receiveTask, RECEIVE_TASK_PERIOD, RECEIVE_TASK_OFFSET);
+	Scheduler_addTask(motorTask, MOTOR_TASK_PERIOD, MOTOR_TASK_OFFSET);
 
-	while(1) {
-		/* Receive the temperature value via UART */
-		temperature = UART_recieveByte();
+	/* Benchmark builds only, see profile.h */
+	PROFILE_INIT();
+	PROFILE_IDLE_LOOP();
 
-		/* Handle different states based on the received temperature value */
-		switch (temperature) {
-		case SHUTDOWN_CODE:
-			/* Transition to SHUTDOWN state */
-			state = SHUTDOWN_STATE;
-			break;
-
-		case ABNORMAL_CODE:
-			/* Handle abnormal state with specific actions */
-			ServoMotor_rotate(ROTATE_TO_90_POSTION);
-			LED_turnAllOff();
-			LED_turnLedOn(RED);
-			Buzzer_on();
-			DcMotor_Rotate(STOP, 0);
-			_delay_ms(5000);
-			Buzzer_off();
-			ServoMotor_rotate(ROTATE_TO_0_POSTION);
-			state = NORMAL_STATE;
-			break;
-
-		default:
-			/* Normal State: set LEDs and buzzer based on temperature thresholds */
-			if (temperature < 20) {
-				LED_turnLedOff(RED);
-				LED_turnLedOff(YELLOW);
-				LED_turnLedOn(GREEN);
-				Buzzer_off();
-			}
-			else if (temperature >= 20 && temperature < 40) {
-				LED_turnLedOff(RED);
-				LED_turnLedOff(GREEN);
-				LED_turnLedOn(YELLOW);
-				Buzzer_off();
-			}
-			else if (temperature >= 40 && temperature <= 50) {
-				LED_turnLedOff(YELLOW);
-				LED_turnLedOff(GREEN);
-				LED_turnLedOn(RED);
-				Buzzer_off();
-			}
-			else if (temperature > 50) {
-				LED_turnLedOff(YELLOW);
-				LED_turnLedOff(GREEN);
-				LED_turnLedOn(RED);
-				Buzzer_on();
-			}
-			break;
-		}
-
-		/* Read the potentiometer value using ADC from channel and calculate motor speed */
-		mvop = ADC_readChannel(PIN4_ID);
-		motorSpeed = (mvop * 100) / 1023;
-
-		/* Control motor based on the current state */
-		if (state == SHUTDOWN_STATE) {
-			DcMotor_Rotate(STOP, 0);
-		}
-		else if (state == NORMAL_STATE) {
-			DcMotor_Rotate(CLOCKWISE, motorSpeed);
-		}
-	}
+	Scheduler_start();
 }
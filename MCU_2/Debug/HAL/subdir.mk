@@ -7,19 +7,22 @@ C_SRCS += \
 ../HAL/buzzer.c \
 ../HAL/dc_motor.c \
 ../HAL/led.c \
-../HAL/servo_motor.c 
+../HAL/servo_motor.c \
+../HAL/servo_mux.c 
 
 OBJS += \
 ./HAL/buzzer.o \
 ./HAL/dc_motor.o \
 ./HAL/led.o \
-./HAL/servo_motor.o 
+./HAL/servo_motor.o \
+./HAL/servo_mux.o 
 
 C_DEPS += \
 ./HAL/buzzer.d \
 ./HAL/dc_motor.d \
 ./HAL/led.d \
-./HAL/servo_motor.d 
+./HAL/servo_motor.d \
+./HAL/servo_mux.d 
 
 
 # Each subdirectory must supply rules for building sources it contributes
@@ -6,24 +6,36 @@
 C_SRCS += \
 ../MCAL/adc.c \
 ../MCAL/gpio.c \
+../MCAL/internal_EEPROM.c \
 ../MCAL/pwm_timer0.c \
+../MCAL/pwm_timer1.c \
+../MCAL/pwm_timer2.c \
 ../MCAL/timer1.c \
+../MCAL/timer2.c \
 ../MCAL/twi.c \
 ../MCAL/uart.c 
 
 OBJS += \
 ./MCAL/adc.o \
 ./MCAL/gpio.o \
+./MCAL/internal_EEPROM.o \
 ./MCAL/pwm_timer0.o \
+./MCAL/pwm_timer1.o \
+./MCAL/pwm_timer2.o \
 ./MCAL/timer1.o \
+./MCAL/timer2.o \
 ./MCAL/twi.o \
 ./MCAL/uart.o 
 
 C_DEPS += \
 ./MCAL/adc.d \
 ./MCAL/gpio.d \
+./MCAL/internal_EEPROM.d \
 ./MCAL/pwm_timer0.d \
+./MCAL/pwm_timer1.d \
+./MCAL/pwm_timer2.d \
 ./MCAL/timer1.d \
+./MCAL/timer2.d \
 ./MCAL/twi.d \
 ./MCAL/uart.d 
 
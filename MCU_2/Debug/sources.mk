@@ -24,4 +24,5 @@ SUBDIRS := \
 APP \
 HAL \
 MCAL \
+SERVICE \
 
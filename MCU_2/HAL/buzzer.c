@@ -10,7 +10,7 @@
  *******************************************************************************/
 
 #include "buzzer.h"
-#include "..\MCAL\gpio.h"  /* to use the gpio functions */
+#include "..\MCAL\gpio_fast.h"  /* to use the compile time pin access */
 
 
 /*******************************************************************************
@@ -26,8 +26,8 @@
  */
 void Buzzer_init()
 {
-	GPIO_setupPinDirection(BUZZER_PORT, BUZZER_PIN, PIN_OUTPUT);
-	GPIO_writePin(BUZZER_PORT, BUZZER_PIN, LOGIC_LOW);
+	GPIO_FAST_SETUP_OUTPUT(BUZZER_PORT, BUZZER_PIN);
+	GPIO_FAST_CLEAR(BUZZER_PORT, BUZZER_PIN);
 }
 
 /*
@@ -37,7 +37,7 @@ void Buzzer_init()
 * Return: None
  */
 void Buzzer_on(void){
-	GPIO_writePin(BUZZER_PORT, BUZZER_PIN, LOGIC_HIGH);
+	GPIO_FAST_SET(BUZZER_PORT, BUZZER_PIN);
 }
 
 /*
@@ -47,5 +47,5 @@ void Buzzer_on(void){
 * Return: No
  */
 void Buzzer_off(void){
-	GPIO_writePin(BUZZER_PORT, BUZZER_PIN, LOGIC_LOW);
+	GPIO_FAST_CLEAR(BUZZER_PORT, BUZZER_PIN);
 }
@@ -12,6 +12,192 @@
 #include "dc_motor.h"
 #include "..\MCAL\gpio.h" /* to use the gpio functions */
 #include "..\MCAL\pwm_timer0.h"
+#include "..\MCAL\pwm_timer1.h"
+#include "..\MCAL\pwm_timer2.h"
+#include <avr/io.h> /* To use the SREG register */
+#include <avr/interrupt.h> /* To use cli() */
+#include <avr/pgmspace.h> /* To read the configuration table from flash */
+#include <util/delay.h> /* For the dead time */
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* No speed asked for since the duty was last changed directly */
+#define DC_MOTOR_NO_REQUEST		0xFF
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+static const DcMotor_ConfigType *g_config = NULL_PTR; /* Configuration table in flash */
+static uint8 g_count = 0;
+static boolean g_rampAvailable = FALSE;  /* TRUE when Timer0 runs, its overflow steps the ramps */
+static volatile uint8 g_rampMask = 0;    /* Bit i set while motor i moves to its target */
+static volatile uint16 g_duty[DC_MOTOR_MAX_INSTANCES];   /* Duty cycle in use, permille */
+static volatile uint16 g_target[DC_MOTOR_MAX_INSTANCES]; /* Duty cycle the ramp moves to, permille */
+static DcMotor_State g_mode[DC_MOTOR_MAX_INSTANCES];     /* Bridge mode in use */
+static uint8 g_speed[DC_MOTOR_MAX_INSTANCES];            /* Speed of the last DcMotor_Rotate in g_mode */
+static volatile uint8 g_kick[DC_MOTOR_MAX_INSTANCES];    /* Ramp ticks left of the start-up kick */
+static volatile uint8 g_inhibitMask = 0; /* Bit i set while motor i is inhibited */
+
+/*******************************************************************************
+ *                      Private Functions Definitions                          *
+ *******************************************************************************/
+
+/* Sends the duty cycle to the PWM output of the motor */
+static void DcMotor_writeDuty(DcMotor_IdType motor, uint16 duty)
+{
+	switch ((DcMotor_PwmType)pgm_read_byte(&g_config[motor].pwm))
+	{
+	case DC_MOTOR_PWM_TIMER0:
+		PWM_setDuty(duty);
+		break;
+	case DC_MOTOR_PWM_TIMER2:
+		PWM_Timer2_setDuty(duty);
+		break;
+	case DC_MOTOR_PWM_TIMER1_A:
+		PWM_Timer1_setDuty(TIMER1_CHANNEL_A, duty);
+		break;
+	case DC_MOTOR_PWM_TIMER1_B:
+		PWM_Timer1_setDuty(TIMER1_CHANNEL_B, duty);
+		break;
+	}
+}
+
+/*
+ * Turns a speed in percent into the duty that gives that airflow: the
+ * calibration table is interpolated between its 10% points and the result is
+ * kept at or above the minimum duty. Only multiplications and flash loads.
+ */
+static uint16 DcMotor_compensate(DcMotor_IdType motor, uint8 speed)
+{
+	const DcMotor_ConfigType *config = &g_config[motor];
+	const uint16 *table;
+	uint16 duty;
+	uint16 minDuty;
+	uint8 index;
+	uint8 rest;
+
+	if (speed == 0)
+	{
+		return 0;
+	}
+
+	table = (const uint16*)pgm_read_ptr(&config->calibration);
+	if (table != NULL_PTR)
+	{
+		index = (uint8)(((uint16)speed * 205) >> 11); /* speed / 10, exact for 0 to 100 */
+		rest = speed - (index * 10);
+		duty = pgm_read_word(&table[index]);
+		if (rest != 0)
+		{
+			sint16 rise = (sint16)(pgm_read_word(&table[index + 1]) - duty);
+			duty += (sint16)(((sint32)rise * rest * 205) >> 11); /* rise * rest / 10 */
+		}
+	}
+	else
+	{
+		duty = (uint16)speed * 10;
+	}
+
+	minDuty = pgm_read_word(&config->minDuty);
+	if (duty < minDuty)
+	{
+		duty = minDuty;
+	}
+
+	return duty;
+}
+
+/*
+ * Timer0 overflow callback, moves every ramping motor one step towards its
+ * target and turns the interrupt off once all of them are there. A motor
+ * being kicked keeps its duty until the kick is over.
+ */
+static void DcMotor_rampTick(void)
+{
+	DcMotor_IdType motor;
+	uint8 mask = g_rampMask;
+
+	for (motor = 0; motor < g_count; motor++)
+	{
+		if (mask & (1 << motor))
+		{
+			uint16 step = pgm_read_word(&g_config[motor].rampStep);
+			uint16 duty = g_duty[motor];
+			uint16 target = g_target[motor];
+
+			if (g_kick[motor] != 0)
+			{
+				g_kick[motor]--;
+				continue;
+			}
+
+			if (step == 0)
+			{
+				duty = target;
+			}
+			else if (target > duty)
+			{
+				duty = ((target - duty) > step) ? (duty + step) : target;
+			}
+			else
+			{
+				duty = ((duty - target) > step) ? (duty - step) : target;
+			}
+
+			g_duty[motor] = duty;
+			DcMotor_writeDuty(motor, duty);
+
+			if (duty == target)
+			{
+				mask &= ~(1 << motor);
+			}
+		}
+	}
+
+	g_rampMask = mask;
+	if (mask == 0)
+	{
+		PWM_Timer0_setOverflowInterrupt(FALSE);
+	}
+}
+
+/*
+ * Moves a running motor to the duty, a motor at standstill first gets the
+ * kick duty for kickTicks ramp ticks. The kick needs the Timer0 ramp tick.
+ */
+static void DcMotor_start(DcMotor_IdType motor, uint16 duty)
+{
+	uint8 kickTicks = pgm_read_byte(&g_config[motor].kickTicks);
+	uint16 kickDuty;
+	uint8 sreg;
+
+	if ((duty == 0) || (kickTicks == 0) || !g_rampAvailable ||
+			(g_target[motor] != 0) || (g_duty[motor] != 0))
+	{
+		DcMotor_rampTo(motor, duty);
+		return;
+	}
+
+	kickDuty = pgm_read_word(&g_config[motor].kickDuty);
+
+	sreg = SREG;
+	cli();
+	if (g_inhibitMask & (1 << motor))
+	{
+		SREG = sreg;
+		return;
+	}
+	g_duty[motor] = kickDuty;
+	g_target[motor] = duty;
+	g_kick[motor] = kickTicks;
+	DcMotor_writeDuty(motor, kickDuty);
+	g_rampMask |= (1 << motor);
+	PWM_Timer0_setOverflowInterrupt(TRUE);
+	SREG = sreg;
+}
 
 /*******************************************************************************
  *                      Functions Definitions                                  *
@@ -20,47 +206,291 @@
 
 /*
  * Description:
- * 	 The Function responsible for setup the direction for the two motor pins through the GPIO driver.
- * 	 Stop at the DC-Motor at the beginning through the GPIO driver.
- * Inputs: None
+ * 	 The Function responsible for setup the direction for the two pins of every motor through the GPIO driver.
+ * 	 Stop every DC-Motor at the beginning through the GPIO driver.
+ * 	 Start each PWM timer used once, the speed changes only update its duty cycle.
+ * Inputs:
+ *	 Config_Ptr: The configuration table in flash, its index is the handle of the motor.
+ *	 count: Number of motors in the table, up to DC_MOTOR_MAX_INSTANCES.
  * Return: None
  */
-void DcMotor_Init(void){
+void DcMotor_Init(const DcMotor_ConfigType *Config_Ptr, uint8 count){
+	DcMotor_IdType motor;
+	boolean timer1Started = FALSE;
+	uint8 port;
+	uint8 pin;
+
+	if (count > DC_MOTOR_MAX_INSTANCES)
+	{
+		count = DC_MOTOR_MAX_INSTANCES;
+	}
+
+	g_config = Config_Ptr;
+	g_count = count;
+	g_rampAvailable = FALSE;
+	g_rampMask = 0;
+	g_inhibitMask = 0;
 
-	GPIO_setupPinDirection(DC_MOTOR_INPUT_1_PORT,DC_MOTOR_INPUT_1_PIN,PIN_OUTPUT);
-	GPIO_setupPinDirection(DC_MOTOR_INPUT_2_PORT,DC_MOTOR_INPUT_2_PIN,PIN_OUTPUT);
-	GPIO_writePin(DC_MOTOR_INPUT_1_PORT,DC_MOTOR_INPUT_1_PIN,LOGIC_LOW);
-	GPIO_writePin(DC_MOTOR_INPUT_2_PORT,DC_MOTOR_INPUT_2_PIN,LOGIC_LOW);
+	for (motor = 0; motor < count; motor++)
+	{
+		port = pgm_read_byte(&Config_Ptr[motor].input1Port);
+		pin = pgm_read_byte(&Config_Ptr[motor].input1Pin);
+		GPIO_setupPinDirection(port,pin,PIN_OUTPUT);
+		GPIO_writePin(port,pin,LOGIC_LOW);
+		port = pgm_read_byte(&Config_Ptr[motor].input2Port);
+		pin = pgm_read_byte(&Config_Ptr[motor].input2Pin);
+		GPIO_setupPinDirection(port,pin,PIN_OUTPUT);
+		GPIO_writePin(port,pin,LOGIC_LOW);
+
+		g_duty[motor] = 0;
+		g_target[motor] = 0;
+		g_mode[motor] = COAST;
+		g_speed[motor] = DC_MOTOR_NO_REQUEST;
+		g_kick[motor] = 0;
+
+		switch ((DcMotor_PwmType)pgm_read_byte(&Config_Ptr[motor].pwm))
+		{
+		case DC_MOTOR_PWM_TIMER0:
+			PWM_Timer0_Init();
+			PWM_Timer0_setCallBack(DcMotor_rampTick);
+			g_rampAvailable = TRUE;
+			break;
+		case DC_MOTOR_PWM_TIMER2:
+			PWM_Timer2_Init();
+			break;
+		case DC_MOTOR_PWM_TIMER1_A:
+		case DC_MOTOR_PWM_TIMER1_B:
+			if (!timer1Started)
+			{
+				PWM_Timer1_Init(pgm_read_dword(&Config_Ptr[motor].frequency));
+				timer1Started = TRUE;
+			}
+			PWM_Timer1_enableChannel((pgm_read_byte(&Config_Ptr[motor].pwm) == DC_MOTOR_PWM_TIMER1_A) ?
+					TIMER1_CHANNEL_A : TIMER1_CHANNEL_B);
+			break;
+		}
+	}
 }
 
 /*
  * Description:
- * 	 The function responsible for rotate the DC Motor CW/ or A-CW or stop the motor based on the state input state value.
- *	 Send the required duty cycle to the PWM driver based on the required speed value.
+ * 	 The function responsible for rotate the DC Motor forward or reverse, or stop it by coasting or braking.
+ *	 A new mode first turns the enable off and opens the bridge for DC_MOTOR_DEAD_TIME_US, so the two
+ *	 patterns never overlap. Forward and reverse then ramp up from 0 at the configured rate.
+ *	 In the same mode only the speed changes. Asking again for the same mode and speed returns before the
+ *	 calibration table is read, until DcMotor_setDuty, DcMotor_rampTo or the inhibit change the duty.
+ *	 The speed is compensated for the motor: it goes through the calibration table and is kept at or
+ *	 above minDuty, and a start from standstill holds kickDuty for kickTicks before the ramp.
  * Inputs:
- *	 state: The required DC Motor state, it should be CW or A-CW or stop. DcMotor_State data type should be declared as enum or uint8.
+ *	 motor: The handle of the motor.
+ *	 state: The required bridge mode: COAST, BRAKE, FORWARD or REVERSE.
  *	 speed: decimal value for the required motor speed, it should be from 0 → 100. For example, if the input is 50, The motor should rotate with 50% of its maximum speed.
+ *	        Not used by COAST and BRAKE, the brake always uses the full enable.
 • Return: None
 */
-void DcMotor_Rotate(DcMotor_State state,uint8 speed){
+void DcMotor_Rotate(DcMotor_IdType motor,DcMotor_State state,uint8 speed){
+	const DcMotor_ConfigType *config;
+	uint8 port1, pin1, port2, pin2;
+
+	if (motor >= g_count)
+	{
+		return;
+	}
+
+	if (speed > 100)
+	{
+		speed = 100;
+	}
+
+	if (state == g_mode[motor])
+	{
+		if (((state == FORWARD) || (state == REVERSE)) && (speed != g_speed[motor]))
+		{
+			DcMotor_start(motor, DcMotor_compensate(motor, speed));
+			g_speed[motor] = speed;
+		}
+		return;
+	}
+
+	config = &g_config[motor];
+	port1 = pgm_read_byte(&config->input1Port);
+	pin1 = pgm_read_byte(&config->input1Pin);
+	port2 = pgm_read_byte(&config->input2Port);
+	pin2 = pgm_read_byte(&config->input2Pin);
+
+	/* Enable off first (every PWM output drops at once at 0%), then open the bridge */
+	DcMotor_setDuty(motor, 0);
+	GPIO_writePin(port1,pin1,LOGIC_LOW);
+	GPIO_writePin(port2,pin2,LOGIC_LOW);
+	g_mode[motor] = COAST;
+
+	if (state == COAST)
+	{
+		return;
+	}
+
+	/* Let the bridge switches turn off before the new pattern */
+	_delay_us(DC_MOTOR_DEAD_TIME_US);
+
 	switch(state)
 	{
-	case STOP:
-		PWM_Timer0_Start(speed);
-		GPIO_writePin(DC_MOTOR_INPUT_1_PORT,DC_MOTOR_INPUT_1_PIN,LOGIC_LOW);
-		GPIO_writePin(DC_MOTOR_INPUT_2_PORT,DC_MOTOR_INPUT_2_PIN,LOGIC_LOW);
+	case BRAKE:
+		DcMotor_setDuty(motor, DC_MOTOR_DUTY_MAX);
+		break;
+	case FORWARD:
+		GPIO_writePin(port2,pin2,LOGIC_HIGH);
+		DcMotor_start(motor, DcMotor_compensate(motor, speed));
 		break;
-	case CLOCKWISE:
-		PWM_Timer0_Start(speed);
-		GPIO_writePin(DC_MOTOR_INPUT_1_PORT,DC_MOTOR_INPUT_1_PIN,LOGIC_LOW);
-		GPIO_writePin(DC_MOTOR_INPUT_2_PORT,DC_MOTOR_INPUT_2_PIN,LOGIC_HIGH);
+	case REVERSE:
+		GPIO_writePin(port1,pin1,LOGIC_HIGH);
+		DcMotor_start(motor, DcMotor_compensate(motor, speed));
 		break;
-	case ANTI_CLOCKWISE:
-		PWM_Timer0_Start(speed);
-		GPIO_writePin(DC_MOTOR_INPUT_1_PORT,DC_MOTOR_INPUT_1_PIN,LOGIC_HIGH);
-		GPIO_writePin(DC_MOTOR_INPUT_2_PORT,DC_MOTOR_INPUT_2_PIN,LOGIC_HIGH);
+	default:
 		break;
 	}
+	g_mode[motor] = state;
+	g_speed[motor] = speed;
+}
+
+/*
+ * Description:
+ * 	 Change only the duty cycle at once, with a finer step than DcMotor_Rotate, the direction pins are kept.
+ * 	 A running ramp is dropped, so this is also the override for emergencies.
+ * 	 The same duty cycle is used whichever PWM timer is selected.
+ * Inputs:
+ *	 motor: The handle of the motor.
+ *	 duty: The duty cycle in permille, from 0 to DC_MOTOR_DUTY_MAX.
+ * Return: None
+ */
+void DcMotor_setDuty(DcMotor_IdType motor,uint16 duty){
+	uint8 sreg;
+
+	if (motor >= g_count)
+	{
+		return;
+	}
+
+	if (duty > DC_MOTOR_DUTY_MAX)
+	{
+		duty = DC_MOTOR_DUTY_MAX;
+	}
+
+	/* The ramp tick also writes the PWM, take the motor out of it first */
+	sreg = SREG;
+	cli();
+	if (g_inhibitMask & (1 << motor))
+	{
+		duty = 0;
+	}
+	g_rampMask &= ~(1 << motor);
+	g_kick[motor] = 0;
+	g_duty[motor] = duty;
+	g_target[motor] = duty;
+	g_speed[motor] = DC_MOTOR_NO_REQUEST;
+	DcMotor_writeDuty(motor, duty);
+	SREG = sreg;
+}
+
+/*
+ * Description:
+ * 	 Move the duty cycle towards a target by rampStep each Timer0 PWM period, from its overflow interrupt.
+ * 	 The interrupt is only enabled while a motor differs from its target.
+ * 	 Asking again for the target already set returns at once.
+ * 	 Without a Timer0 motor or with a rampStep of 0 the duty cycle is set at once.
+ * Inputs:
+ *	 motor: The handle of the motor.
+ *	 duty: The target duty cycle in permille, from 0 to DC_MOTOR_DUTY_MAX.
+ * Return: None
+ */
+void DcMotor_rampTo(DcMotor_IdType motor,uint16 duty){
+	uint8 sreg;
+
+	if (motor >= g_count)
+	{
+		return;
+	}
+
+	if (duty > DC_MOTOR_DUTY_MAX)
+	{
+		duty = DC_MOTOR_DUTY_MAX;
+	}
+
+	g_speed[motor] = DC_MOTOR_NO_REQUEST;
+
+	/* Only written here and in DcMotor_setDuty, so it can be read without a lock */
+	if (duty == g_target[motor])
+	{
+		return;
+	}
 
+	if (!g_rampAvailable || (pgm_read_word(&g_config[motor].rampStep) == 0))
+	{
+		DcMotor_setDuty(motor, duty);
+		return;
+	}
+
+	sreg = SREG;
+	cli();
+	if (g_inhibitMask & (1 << motor))
+	{
+		/* Already at 0, set with the inhibit */
+		SREG = sreg;
+		return;
+	}
+	g_target[motor] = duty;
+	if (g_duty[motor] != duty)
+	{
+		g_rampMask |= (1 << motor);
+		PWM_Timer0_setOverflowInterrupt(TRUE);
+	}
+	else
+	{
+		g_rampMask &= ~(1 << motor);
+		g_kick[motor] = 0;
+	}
+	SREG = sreg;
 }
 
+/*
+ * Description:
+ * 	 Inhibit a motor after a fault, or allow it to run again. While inhibited every duty cycle asked for is 0,
+ * 	 the checks are done with the interrupts off, together with the writes they guard.
+ * 	 Can be called from an interrupt.
+ * Inputs:
+ *	 motor: The handle of the motor.
+ *	 inhibit: TRUE to inhibit the motor, FALSE to allow it to run.
+ * Return: None
+ */
+void DcMotor_setInhibit(DcMotor_IdType motor,boolean inhibit){
+	uint8 sreg;
+
+	if (motor >= g_count)
+	{
+		return;
+	}
+
+	sreg = SREG;
+	cli();
+	if (inhibit)
+	{
+		g_inhibitMask |= (1 << motor);
+		DcMotor_setDuty(motor, 0);
+	}
+	else
+	{
+		g_inhibitMask &= ~(1 << motor);
+		g_speed[motor] = DC_MOTOR_NO_REQUEST;
+	}
+	SREG = sreg;
+}
+
+/*
+ * Description:
+ * 	 Tell if the motor is inhibited.
+ * Inputs:
+ *	 motor: The handle of the motor.
+ * Return: TRUE while the motor is inhibited.
+ */
+boolean DcMotor_isInhibited(DcMotor_IdType motor){
+	return (g_inhibitMask & (1 << motor)) ? TRUE : FALSE;
+}
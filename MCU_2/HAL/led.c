@@ -12,6 +12,7 @@
 
 #include "led.h"
 #include "..\MCAL\gpio.h"
+#include "..\MCAL\gpio_fast.h" /* The LED pins are fixed, one instruction each */
 #include "..\std_types.h"
 
 /*******************************************************************************
@@ -29,9 +30,9 @@
  * Description: Initializes the LED pins by setting up their direction as output.
  *******************************************************************************/
 void LED_init(void) {
-	GPIO_setupPinDirection(RED_LED_PORT, RED_LED_PIN, PIN_OUTPUT);
-	GPIO_setupPinDirection(YELLOW_LED_PORT, YELLOW_LED_PIN, PIN_OUTPUT);
-	GPIO_setupPinDirection(GREEN_LED_PORT, GREEN_LED_PIN, PIN_OUTPUT);
+	GPIO_FAST_SETUP_OUTPUT(RED_LED_PORT, RED_LED_PIN);
+	GPIO_FAST_SETUP_OUTPUT(YELLOW_LED_PORT, YELLOW_LED_PIN);
+	GPIO_FAST_SETUP_OUTPUT(GREEN_LED_PORT, GREEN_LED_PIN);
 }
 
 /******************************************************************************
@@ -48,13 +49,13 @@ void LED_turnLedOn(colorType Color) {
 
 	switch (Color) {
 		case RED:
-			GPIO_writePin(RED_LED_PORT, RED_LED_PIN, LOGIC_HIGH);
+			GPIO_FAST_SET(RED_LED_PORT, RED_LED_PIN);
 			break;
 		case YELLOW:
-			GPIO_writePin(YELLOW_LED_PORT, YELLOW_LED_PIN, LOGIC_HIGH);
+			GPIO_FAST_SET(YELLOW_LED_PORT, YELLOW_LED_PIN);
 			break;
 		case GREEN:
-			GPIO_writePin(GREEN_LED_PORT, GREEN_LED_PIN, LOGIC_HIGH);
+			GPIO_FAST_SET(GREEN_LED_PORT, GREEN_LED_PIN);
 			break;
 		default:
 			break;
@@ -76,13 +77,13 @@ void LED_turnLedOff(colorType Color) {
 
 	switch (Color) {
 		case RED:
-			GPIO_writePin(RED_LED_PORT, RED_LED_PIN, LOGIC_LOW);
+			GPIO_FAST_CLEAR(RED_LED_PORT, RED_LED_PIN);
 			break;
 		case YELLOW:
-			GPIO_writePin(YELLOW_LED_PORT, YELLOW_LED_PIN, LOGIC_LOW);
+			GPIO_FAST_CLEAR(YELLOW_LED_PORT, YELLOW_LED_PIN);
 			break;
 		case GREEN:
-			GPIO_writePin(GREEN_LED_PORT, GREEN_LED_PIN, LOGIC_LOW);
+			GPIO_FAST_CLEAR(GREEN_LED_PORT, GREEN_LED_PIN);
 			break;
 		default:
 			break;
@@ -102,9 +103,7 @@ void LED_turnLedOff(colorType Color) {
  *******************************************************************************/
 void LED_turnAllOn(void) {
 
-	GPIO_writePin(RED_LED_PORT, RED_LED_PIN, LOGIC_HIGH);
-	GPIO_writePin(YELLOW_LED_PORT, YELLOW_LED_PIN, LOGIC_HIGH);
-	GPIO_writePin(GREEN_LED_PORT, GREEN_LED_PIN, LOGIC_HIGH);
+	LED_setPattern(LED_PATTERN_ALL);
 
 }
 
@@ -120,9 +119,22 @@ void LED_turnAllOn(void) {
  *******************************************************************************/
 void LED_turnAllOff(void) {
 
-	GPIO_writePin(RED_LED_PORT, RED_LED_PIN, LOGIC_LOW);
-	GPIO_writePin(YELLOW_LED_PORT, YELLOW_LED_PIN, LOGIC_LOW);
-	GPIO_writePin(GREEN_LED_PORT, GREEN_LED_PIN, LOGIC_LOW);
+	LED_setPattern(LED_PATTERN_NONE);
+}
+
+/******************************************************************************
+ * Service Name: LED_setPattern
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters (in): pattern - The LEDs to turn on (LED_PATTERN_* bits), the others are turned off
+ * Parameters (inout): None
+ * Parameters (out): None
+ * Return value: None
+ * Description: Writes the LED pins of the port in one store, the other pins
+ *              of the port are kept.
+ *******************************************************************************/
+void LED_setPattern(uint8 pattern) {
+	GPIO_writeMasked(LED_PORT, LED_PATTERN_ALL, pattern);
 }
 
 
@@ -14,6 +14,7 @@
 #define LED_H_
 
 #include "..\std_types.h"
+#include "..\MCAL\gpio.h" /* For the port and pin IDs */
 
 /*******************************************************************************
  *                                Definitions                                  *
@@ -27,6 +28,19 @@
 #define YELLOW_LED_PIN		PIN6_ID
 #define GREEN_LED_PIN		PIN5_ID
 
+/* The LEDs share one port so a pattern is written in a single store */
+#define LED_PORT			RED_LED_PORT
+#if (YELLOW_LED_PORT != LED_PORT) || (GREEN_LED_PORT != LED_PORT)
+#error "All the LEDs must be on the same port"
+#endif
+
+/* Bits of a pattern for LED_setPattern, they can be combined with | */
+#define LED_PATTERN_NONE	0
+#define LED_PATTERN_RED		(1 << RED_LED_PIN)
+#define LED_PATTERN_YELLOW	(1 << YELLOW_LED_PIN)
+#define LED_PATTERN_GREEN	(1 << GREEN_LED_PIN)
+#define LED_PATTERN_ALL		(LED_PATTERN_RED | LED_PATTERN_YELLOW | LED_PATTERN_GREEN)
+
 /*******************************************************************************
  *                               Types Declaration                             *
  *******************************************************************************/
@@ -102,4 +116,16 @@ void LED_turnAllOn(void);
  *******************************************************************************/
 void LED_turnAllOff(void);
 
+/******************************************************************************
+ * Service Name: LED_setPattern
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters (in): pattern - The LEDs to turn on (LED_PATTERN_* bits), the others are turned off
+ * Parameters (inout): None
+ * Parameters (out): None
+ * Return value: None
+ * Description: Sets all the LEDs at once, no mix of the old and new pattern is ever shown.
+ *******************************************************************************/
+void LED_setPattern(uint8 pattern);
+
 #endif /* LED_H_ */
@@ -13,8 +13,132 @@
 
 
 #include "servo_motor.h"
-#include "..\MCAL\timer1.h"
-#include "..\MCAL\gpio.h"
+#include "servo_mux.h"
+#include <avr/io.h> /* To use the SREG register */
+#include <avr/interrupt.h> /* To use cli() */
+#include <avr/pgmspace.h> /* To read the calibration table from flash */
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * Positions are kept in 1/256 of a calibration step, so the table index and
+ * the interpolation fraction are the high and low bytes of the position.
+ */
+#define SERVO_POSITION_SCALE	256
+#define SERVO_POSITION_MAX		((SERVO_CALIBRATION_POINTS - 1) * SERVO_POSITION_SCALE)
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+static uint8 g_channel = 0;             /* Servo multiplexer channel */
+static const uint16 *g_calibration = NULL_PTR; /* Calibration table in flash */
+static uint16 g_maxSpeed = 0;           /* Position units per frame */
+static uint16 g_acceleration = 0;       /* Position units per frame, per frame */
+static volatile uint16 g_position = 0;  /* Position of the pulse sent */
+static volatile uint16 g_target = 0;    /* Position the move ends on */
+static sint16 g_velocity = 0;           /* Position units per frame, only used in the frame interrupt */
+static uint16 g_pulse = 0;              /* Pulse width in use */
+static volatile boolean g_moving = FALSE;
+
+/*******************************************************************************
+ *                      Private Functions Definitions                          *
+ *******************************************************************************/
+
+/* Pulse width of a position, interpolated in the calibration table */
+static uint16 ServoMotor_pulse(uint16 position)
+{
+	uint8 index = (uint8)(position >> 8);
+	uint8 fraction = (uint8)position;
+	uint16 pulse = pgm_read_word(&g_calibration[index]);
+
+	if (fraction != 0)
+	{
+		sint16 rise = (sint16)(pgm_read_word(&g_calibration[index + 1]) - pulse);
+		pulse += (sint16)(((sint32)rise * fraction) >> 8);
+	}
+
+	return pulse;
+}
+
+/*
+ * Servo multiplexer frame callback, once per 50Hz frame. The velocity grows by
+ * the acceleration up to the maximum speed and shrinks again once the
+ * distance left is only just enough to stop (v² >= 2·a·d), the step that
+ * would reach the target lands on it. Only the channel width is written, the
+ * new pulse starts in this frame. The callback is removed at the target.
+ * Braking is the longest path: 32-bit products in the brake test and the
+ * interpolation, the call to ServoMux_setWidth. It has to fit
+ * SERVO_MUX_FIRST_RISE.
+ */
+static void ServoMotor_frame(void)
+{
+	uint16 position = g_position;
+	sint16 error = (sint16)(g_target - position);
+	sint16 velocity = g_velocity;
+	uint16 distance = (error < 0) ? -error : error;
+	uint16 speed = (velocity < 0) ? -velocity : velocity;
+	uint16 pulse;
+
+	if (g_acceleration == 0)
+	{
+		velocity = (error < 0) ? -(sint16)g_maxSpeed : (sint16)g_maxSpeed;
+	}
+	else if (((velocity != 0) && ((error < 0) != (velocity < 0))) ||
+			(((uint32)speed * speed) >= (2UL * g_acceleration * distance)))
+	{
+		/* Moving away from the target or time to brake */
+		if (speed > g_acceleration)
+		{
+			velocity += (velocity < 0) ? (sint16)g_acceleration : -(sint16)g_acceleration;
+		}
+		else
+		{
+			velocity = 0;
+		}
+	}
+	else
+	{
+		velocity += (error < 0) ? -(sint16)g_acceleration : (sint16)g_acceleration;
+		if (velocity > (sint16)g_maxSpeed)
+		{
+			velocity = g_maxSpeed;
+		}
+		else if (velocity < -(sint16)g_maxSpeed)
+		{
+			velocity = -(sint16)g_maxSpeed;
+		}
+	}
+
+	speed = (velocity < 0) ? -velocity : velocity;
+	if ((error == 0) || ((speed >= distance) && ((error < 0) == (velocity < 0))))
+	{
+		position = g_target;
+		velocity = 0;
+	}
+	else
+	{
+		position += velocity;
+	}
+
+	g_position = position;
+	g_velocity = velocity;
+
+	pulse = ServoMotor_pulse(position);
+	if (pulse != g_pulse)
+	{
+		g_pulse = pulse;
+		ServoMux_setWidth(g_channel, pulse);
+	}
+
+	if ((position == g_target) && (velocity == 0))
+	{
+		g_moving = FALSE;
+		ServoMux_setFrameCallBack(NULL_PTR);
+	}
+}
 
 /*******************************************************************************
  *                      Functions Definitions                                  *
@@ -23,27 +147,120 @@
 /******************************************************************************
  * Service Name: ServoMotor_init
  * Sync/Async: Synchronous
- * Reentrancy: Reentrant
- * Parameters (in): None
+ * Reentrancy: Non-reentrant
+ * Parameters (in): Config_Ptr - The calibration table and the motion profile
  * Parameters (inout): None
  * Parameters (out): None
  * Return value: None
- * Description: Initializes the servo motor by setting up the control pin direction.
+ * Description: Initializes the servo motor at the 0 degree position on its
+ *              channel of the servo multiplexer. The profile limits are turned
+ *              into position units per frame here, so the frame interrupt only
+ *              adds and multiplies.
  *******************************************************************************/
-void ServoMotor_init(void) {
-	GPIO_setupPinDirection(PORTD_ID,PIN5_ID, PIN_OUTPUT);
+void ServoMotor_init(const ServoMotor_ConfigType *Config_Ptr) {
+	uint32 speed;
+
+	g_channel = Config_Ptr->channel;
+	g_calibration = Config_Ptr->calibration;
+
+	/* deg/s to units per frame, at most the full travel in one frame */
+	speed = ((uint32)Config_Ptr->maxSpeed * SERVO_POSITION_SCALE) / (SERVO_CALIBRATION_STEP * SERVO_FRAME_RATE);
+	g_maxSpeed = (speed > SERVO_POSITION_MAX) ? SERVO_POSITION_MAX : (uint16)speed;
+	if ((g_maxSpeed == 0) && (Config_Ptr->maxSpeed != 0))
+	{
+		g_maxSpeed = 1;
+	}
+
+	/* deg/s² to units per frame² */
+	speed = ((uint32)Config_Ptr->acceleration * SERVO_POSITION_SCALE) /
+			((uint32)SERVO_CALIBRATION_STEP * SERVO_FRAME_RATE * SERVO_FRAME_RATE);
+	g_acceleration = (speed > g_maxSpeed) ? g_maxSpeed : (uint16)speed;
+	if ((g_acceleration == 0) && (Config_Ptr->acceleration != 0))
+	{
+		g_acceleration = 1;
+	}
+
+	g_position = 0;
+	g_target = 0;
+	g_velocity = 0;
+	g_moving = FALSE;
+	g_pulse = ServoMotor_pulse(0);
+	ServoMux_setWidth(g_channel, g_pulse);
 }
 
 /******************************************************************************
  * Service Name: ServoMotor_rotate
- * Sync/Async: Synchronous
- * Reentrancy: Reentrant
+ * Sync/Async: Asynchronous
+ * Reentrancy: Non-reentrant
  * Parameters (in): degree - The angle to rotate the servo motor to (0 to 180 degrees)
  * Parameters (inout): None
  * Parameters (out): None
  * Return value: None
- * Description: Rotates the servo motor to a specific angle by generating the corresponding PWM signal.
+ * Description: Sets the target of the move and sets the frame callback, the
+ *              frames keep running so no pulse is cut. Without a maximum speed
+ *              the pulse of the angle is set at once.
  *******************************************************************************/
 void ServoMotor_rotate(uint16 degree) {
-	Timer1_Fast_PWM_Init(degree);
+	uint16 target;
+	uint8 sreg;
+
+	if (degree > SERVO_MAX_ANGLE)
+	{
+		degree = SERVO_MAX_ANGLE;
+	}
+	target = (uint16)(((uint32)degree * SERVO_POSITION_SCALE) / SERVO_CALIBRATION_STEP);
+
+	if (g_maxSpeed == 0)
+	{
+		g_position = target;
+		g_target = target;
+		g_pulse = ServoMotor_pulse(target);
+		ServoMux_setWidth(g_channel, g_pulse);
+		return;
+	}
+
+	sreg = SREG;
+	cli();
+	g_target = target;
+	if (!g_moving && (g_position != target))
+	{
+		g_moving = TRUE;
+		ServoMux_setFrameCallBack(ServoMotor_frame);
+	}
+	SREG = sreg;
+}
+
+/******************************************************************************
+ * Service Name: ServoMotor_getAngle
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters (in): None
+ * Parameters (inout): None
+ * Parameters (out): None
+ * Return value: uint8 - The angle of the pulse sent, in degrees
+ * Description: Returns where the servo is being driven along its move.
+ *******************************************************************************/
+uint8 ServoMotor_getAngle(void) {
+	uint16 position;
+	uint8 sreg = SREG;
+
+	cli();
+	position = g_position;
+	SREG = sreg;
+
+	return (uint8)((((uint32)position * SERVO_CALIBRATION_STEP) + (SERVO_POSITION_SCALE / 2)) / SERVO_POSITION_SCALE);
+}
+
+/******************************************************************************
+ * Service Name: ServoMotor_isMoving
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters (in): None
+ * Parameters (inout): None
+ * Parameters (out): None
+ * Return value: boolean - TRUE until the pulse reaches the requested angle
+ * Description: Tells if a move is still in progress.
+ *******************************************************************************/
+boolean ServoMotor_isMoving(void) {
+	return g_moving;
 }
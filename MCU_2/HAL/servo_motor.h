@@ -20,9 +20,25 @@
  *                                Definitions                                  *
  *******************************************************************************/
 
-#define ROTATE_TO_0_POSTION		 124
-#define ROTATE_TO_90_POSTION	 187
-#define ROTATE_TO_180_POSTION	 250
+#define SERVO_MAX_ANGLE			 180
+
+/* The calibration table has one pulse width every 10 degrees, 0 to 180 */
+#define SERVO_CALIBRATION_STEP	 10
+#define SERVO_CALIBRATION_POINTS ((SERVO_MAX_ANGLE / SERVO_CALIBRATION_STEP) + 1)
+
+/* 50Hz servo frame of the servo multiplexer, the motion profile is updated once per frame */
+#define SERVO_FRAME_RATE		 50
+
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+
+typedef struct {
+	uint8 channel;             /* Servo multiplexer channel of the servo */
+	const uint16 *calibration; /* Pulse width in Timer1 counts (8us) for each calibration point, in flash */
+	uint16 maxSpeed;           /* deg/s, 0 moves to the new angle at once */
+	uint16 acceleration;       /* deg/s², 0 moves at maxSpeed from the start (rate limited) */
+} ServoMotor_ConfigType;
 
 /*******************************************************************************
  *                              Functions Prototypes                           *
@@ -31,26 +47,53 @@
 /******************************************************************************
  * Service Name: ServoMotor_init
  * Sync/Async: Synchronous
- * Reentrancy: Reentrant
- * Parameters (in): None
+ * Reentrancy: Non-reentrant
+ * Parameters (in): Config_Ptr - The calibration table and the motion profile
  * Parameters (inout): None
  * Parameters (out): None
  * Return value: None
- * Description: Initializes the servo motor by setting up the control pin direction.
+ * Description: Initializes the servo motor at 0 degrees on its channel of the
+ *              servo multiplexer, to be called after ServoMux_init.
  *******************************************************************************/
-void ServoMotor_init(void);
+void ServoMotor_init(const ServoMotor_ConfigType *Config_Ptr);
 
 /******************************************************************************
  * Service Name: ServoMotor_rotate
- * Sync/Async: Synchronous
- * Reentrancy: Reentrant
+ * Sync/Async: Asynchronous
+ * Reentrancy: Non-reentrant
  * Parameters (in): degree - The angle to rotate the servo motor to (0 to 180 degrees)
  * Parameters (inout): None
  * Parameters (out): None
  * Return value: None
- * Description: Rotates the servo motor to a specific angle by generating the corresponding PWM signal.
+ * Description: Starts the move to a new angle, the servo accelerates, cruises at
+ *              the maximum speed and brakes to stop on the angle. A new angle
+ *              during a move takes over from the current speed.
  *******************************************************************************/
 void ServoMotor_rotate(uint16 degree);
 
+/******************************************************************************
+ * Service Name: ServoMotor_getAngle
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters (in): None
+ * Parameters (inout): None
+ * Parameters (out): None
+ * Return value: uint8 - The angle of the pulse sent, in degrees
+ * Description: Returns where the servo is being driven along its move.
+ *******************************************************************************/
+uint8 ServoMotor_getAngle(void);
+
+/******************************************************************************
+ * Service Name: ServoMotor_isMoving
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters (in): None
+ * Parameters (inout): None
+ * Parameters (out): None
+ * Return value: boolean - TRUE until the pulse reaches the requested angle
+ * Description: Tells if a move is still in progress.
+ *******************************************************************************/
+boolean ServoMotor_isMoving(void);
+
 
 #endif /* SERVO_MOTOR_H_ */
@@ -0,0 +1,180 @@
+/******************************************************************************
+ *
+ * Module: Servo Multiplexer
+ *
+ * File Name: servo_mux.c
+ *
+ * Description: Source file for the servo multiplexer
+ *
+ * Author: Mohamed Hisham
+ *
+ *******************************************************************************/
+
+#include "servo_mux.h"
+#include "servo_mux_isr.h"
+#include "..\MCAL\gpio.h"
+#include "..\MCAL\timer1.h"
+#include "..\MCAL\isr_config.h"
+#include <avr/io.h> /* To use the SREG and PORT registers */
+#include <avr/interrupt.h> /* To use cli() */
+#include <avr/pgmspace.h> /* To read the channel table from flash */
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+/* Used by ServoMux_edge in servo_mux_isr.h */
+volatile uint8 *g_muxPort[SERVO_MUX_MAX_CHANNELS];
+uint8 g_muxMask[SERVO_MUX_MAX_CHANNELS];
+volatile uint16 g_muxWidth[SERVO_MUX_MAX_CHANNELS];
+uint8 g_muxCount = 0;
+uint8 g_muxChannel = 0;
+volatile uint8 *g_muxEdgePort = NULL_PTR;
+uint8 g_muxEdgeMask = 0;
+uint8 g_muxEdgeLevel = 0;
+uint16 g_muxEdgeDelay = 0xFFFF;
+
+/*******************************************************************************
+ *                      Private Functions Definitions                          *
+ *******************************************************************************/
+
+/* Output register of a port */
+static volatile uint8 *ServoMux_portRegister(uint8 port_num)
+{
+	switch (port_num)
+	{
+	case PORTA_ID:
+		return &PORTA;
+	case PORTB_ID:
+		return &PORTB;
+	case PORTC_ID:
+		return &PORTC;
+	default:
+		return &PORTD;
+	}
+}
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+/******************************************************************************
+ * Service Name: ServoMux_init
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-reentrant
+ * Parameters (in): Config_Ptr - The channel table in flash, its index is the channel
+ *                  count - Number of channels, up to SERVO_MUX_MAX_CHANNELS
+ * Parameters (inout): None
+ * Parameters (out): None
+ * Return value: None
+ * Description: Timer1 runs in CTC mode with the frame in OCR1A, the compare A
+ *              interrupt marks the frames and the compare B interrupt makes
+ *              the edges, through ServoMux_edge unless it is bound to the
+ *              vector in isr_config.h. The other pins of a channel port may
+ *              be written with GPIO_writePin, which keeps the interrupts off
+ *              around its read-modify-write, but not with GPIO_writePort.
+ *******************************************************************************/
+void ServoMux_init(const ServoMux_ChannelType *Config_Ptr, uint8 count)
+{
+	Timer1_ConfigType timer_config;
+	uint8 channel;
+
+	if (count > SERVO_MUX_MAX_CHANNELS)
+	{
+		count = SERVO_MUX_MAX_CHANNELS;
+	}
+
+	if (count == 0)
+	{
+		return;
+	}
+
+	for (channel = 0; channel < count; channel++)
+	{
+		uint8 port = pgm_read_byte(&Config_Ptr[channel].port);
+		uint8 pin = pgm_read_byte(&Config_Ptr[channel].pin);
+
+		GPIO_setupPinDirection(port, pin, PIN_OUTPUT);
+		GPIO_writePin(port, pin, LOGIC_LOW);
+
+		g_muxPort[channel] = ServoMux_portRegister(port);
+		g_muxMask[channel] = (1 << pin);
+		g_muxWidth[channel] = 0;
+		ServoMux_setWidth(channel, pgm_read_word(&Config_Ptr[channel].width));
+	}
+	g_muxCount = count;
+
+	/* The first edge is the rise of channel 0 */
+	g_muxChannel = 0;
+	g_muxEdgePort = g_muxPort[0];
+	g_muxEdgeMask = g_muxMask[0];
+	g_muxEdgeLevel = g_muxMask[0];
+	g_muxEdgeDelay = 0xFFFF;
+
+	timer_config.initial_value = 0;
+	timer_config.compare_value = SERVO_MUX_FRAME_TOP;
+	timer_config.compare_b_value = SERVO_MUX_FIRST_RISE;
+	timer_config.top_value = 0;
+	timer_config.prescaler = PRESCALER_8;
+	timer_config.mode = COMPARE_MODE;
+	timer_config.output_a = OUTPUT_DISCONNECTED;
+	timer_config.output_b = OUTPUT_DISCONNECTED;
+	timer_config.capture_edge = CAPTURE_RISING_EDGE;
+
+#ifndef TIMER1_COMPB_HANDLER
+	Timer1_setCallBack(TIMER1_COMPARE_B_EVENT, ServoMux_edge);
+#endif
+	Timer1_init(&timer_config);
+}
+
+/******************************************************************************
+ * Service Name: ServoMux_setWidth
+ * Sync/Async: Asynchronous
+ * Reentrancy: Reentrant
+ * Parameters (in): channel - The channel
+ *                  width - Pulse width in counts, SERVO_MUX_MIN_WIDTH to SERVO_MUX_MAX_WIDTH
+ * Parameters (inout): None
+ * Parameters (out): None
+ * Return value: None
+ * Description: The width is clamped to its limits, the edge interrupt reads it
+ *              at the rise of the channel.
+ *******************************************************************************/
+void ServoMux_setWidth(uint8 channel, uint16 width)
+{
+	uint8 sreg;
+
+	if (channel >= SERVO_MUX_MAX_CHANNELS)
+	{
+		return;
+	}
+
+	if (width < SERVO_MUX_MIN_WIDTH)
+	{
+		width = SERVO_MUX_MIN_WIDTH;
+	}
+	else if (width > SERVO_MUX_MAX_WIDTH)
+	{
+		width = SERVO_MUX_MAX_WIDTH;
+	}
+
+	/* 16-bit value shared with the edge interrupt */
+	sreg = SREG;
+	cli();
+	g_muxWidth[channel] = width;
+	SREG = sreg;
+}
+
+/******************************************************************************
+ * Service Name: ServoMux_setFrameCallBack
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-reentrant
+ * Parameters (in): a_ptr - Called at the start of each frame, NULL_PTR for none
+ * Parameters (inout): None
+ * Parameters (out): None
+ * Return value: None
+ * Description: The compare A interrupt is only enabled while a callback is set.
+ *******************************************************************************/
+void ServoMux_setFrameCallBack(void(*a_ptr)(void))
+{
+	Timer1_setCallBack(TIMER1_COMPARE_A_EVENT, a_ptr);
+}
@@ -0,0 +1,106 @@
+/******************************************************************************
+ *
+ * Module: Servo Multiplexer
+ *
+ * File Name: servo_mux.h
+ *
+ * Description: Header file for the servo multiplexer, generates up to 8 servo
+ *              pulses on any GPIO pins from the Timer1 compare interrupts
+ *
+ * Author: Mohamed Hisham
+ *
+ *******************************************************************************/
+
+#ifndef SERVO_MUX_H_
+#define SERVO_MUX_H_
+
+#include "..\std_types.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+#define SERVO_MUX_MAX_CHANNELS	8
+
+/* 50Hz frame: Timer1 in CTC mode counts 0 to 2499, one count every 8us at F_CPU/8 */
+#define SERVO_MUX_FRAME_TOP		2499
+
+/*
+ * The pulses follow each other: the interrupt that ends the pulse of a
+ * channel starts the pulse of the next one, so the pulses never overlap and
+ * a frame only needs the sum of the widths in use. Channel 0 rises at
+ * SERVO_MUX_FIRST_RISE, after the frame interrupt at TOP. A frame interrupt
+ * that runs longer delays all the pulses of the frame by the same time, the
+ * room left after 8 pulses of the maximum width takes up that delay.
+ */
+#define SERVO_MUX_FIRST_RISE	120
+
+/*
+ * Pulse widths in counts. The minimum leaves the edge interrupt time to
+ * schedule the fall, the maximum keeps a gap before the next slot.
+ */
+#define SERVO_MUX_MIN_WIDTH		62		/* 0.5ms */
+#define SERVO_MUX_MAX_WIDTH		288		/* 2.3ms */
+
+#if (SERVO_MUX_FIRST_RISE + (SERVO_MUX_MAX_CHANNELS * SERVO_MUX_MAX_WIDTH)) >= SERVO_MUX_FRAME_TOP
+#error "The servo pulses do not fit the frame"
+#endif
+
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+
+/* One entry of the channel table, the table is kept in flash (PROGMEM) */
+typedef struct {
+	uint8 port;
+	uint8 pin;
+	uint16 width;             /* Pulse width in counts at start-up */
+} ServoMux_ChannelType;
+
+/*******************************************************************************
+ *                              Functions Prototypes                           *
+ *******************************************************************************/
+
+/******************************************************************************
+ * Service Name: ServoMux_init
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-reentrant
+ * Parameters (in): Config_Ptr - The channel table in flash, its index is the channel
+ *                  count - Number of channels, up to SERVO_MUX_MAX_CHANNELS
+ * Parameters (inout): None
+ * Parameters (out): None
+ * Return value: None
+ * Description: Sets the channel pins as outputs and takes Timer1 to generate
+ *              the pulses, OC1A and OC1B stay disconnected.
+ *******************************************************************************/
+void ServoMux_init(const ServoMux_ChannelType *Config_Ptr, uint8 count);
+
+/******************************************************************************
+ * Service Name: ServoMux_setWidth
+ * Sync/Async: Asynchronous
+ * Reentrancy: Reentrant
+ * Parameters (in): channel - The channel
+ *                  width - Pulse width in counts, SERVO_MUX_MIN_WIDTH to SERVO_MUX_MAX_WIDTH
+ * Parameters (inout): None
+ * Parameters (out): None
+ * Return value: None
+ * Description: Changes the pulse width of a channel, from its next pulse. A
+ *              pulse already started keeps its width.
+ *******************************************************************************/
+void ServoMux_setWidth(uint8 channel, uint16 width);
+
+/******************************************************************************
+ * Service Name: ServoMux_setFrameCallBack
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-reentrant
+ * Parameters (in): a_ptr - Called at the start of each frame, NULL_PTR for none
+ * Parameters (inout): None
+ * Parameters (out): None
+ * Return value: None
+ * Description: The callback runs from the Timer1 compare A interrupt at TOP,
+ *              it should complete within SERVO_MUX_FIRST_RISE counts or the
+ *              pulses of the frame start late.
+ *******************************************************************************/
+void ServoMux_setFrameCallBack(void(*a_ptr)(void));
+
+#endif /* SERVO_MUX_H_ */
@@ -0,0 +1,95 @@
+/******************************************************************************
+ *
+ * Module: Servo Multiplexer
+ *
+ * File Name: servo_mux_isr.h
+ *
+ * Description: Inline edge handler of the servo multiplexer, bound to the
+ *              Timer1 compare B vector in isr_config.h
+ *
+ * Author: Mohamed Hisham
+ *
+ *******************************************************************************/
+
+#ifndef SERVO_MUX_ISR_H_
+#define SERVO_MUX_ISR_H_
+
+#include "servo_mux.h"
+#include <avr/io.h>
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+/* Owned by servo_mux.c */
+extern volatile uint8 *g_muxPort[SERVO_MUX_MAX_CHANNELS];  /* Output register of each channel */
+extern uint8 g_muxMask[SERVO_MUX_MAX_CHANNELS];            /* Pin mask of each channel */
+extern volatile uint16 g_muxWidth[SERVO_MUX_MAX_CHANNELS]; /* Pulse width of each channel */
+extern uint8 g_muxCount;
+extern uint8 g_muxChannel;               /* Channel of the next edge */
+extern volatile uint8 *g_muxEdgePort;    /* Output register of the next edge */
+extern uint8 g_muxEdgeMask;
+extern uint8 g_muxEdgeLevel;             /* The pin mask for a rise, 0 for a fall */
+extern uint16 g_muxEdgeDelay;            /* Least counts seen from a compare match to its edge */
+
+/*******************************************************************************
+ *                              Functions Definitions                          *
+ *******************************************************************************/
+
+/*
+ * Timer1 compare B handler, makes one edge and schedules the next one in
+ * OCR1B. The edge is written first and the counter read right after it, with
+ * the same instructions for a rise and a fall, so the counts from the compare
+ * match to the read are the delay of the edge. The least delay seen is the
+ * one of an edge on time. A fall is followed at once by the rise of the next
+ * channel, except after the last one, whose next channel is channel 0 at
+ * SERVO_MUX_FIRST_RISE of the next frame. Falls are scheduled from the
+ * compare match of the edge before them, so an edge held back by another
+ * interrupt moves the next fall by the same time and the pulse keeps its
+ * width, within a count. OCR1B is not double buffered in CTC mode, the new
+ * value is used at once.
+ */
+static inline __attribute__((always_inline)) void ServoMux_edge(void)
+{
+	volatile uint8 *port = g_muxEdgePort;
+	uint8 channel = g_muxChannel;
+	uint16 now;
+	uint16 delay;
+
+	*port = (*port & ~g_muxEdgeMask) | g_muxEdgeLevel;
+	now = TCNT1;
+
+	delay = now - OCR1B;
+	if (delay < g_muxEdgeDelay)
+	{
+		g_muxEdgeDelay = delay;
+	}
+
+	if (g_muxEdgeLevel == 0)
+	{
+		channel++;
+		if (channel >= g_muxCount)
+		{
+			/* End of the frame, channel 0 rises in the next one */
+			OCR1B = SERVO_MUX_FIRST_RISE;
+			g_muxChannel = 0;
+			g_muxEdgePort = g_muxPort[0];
+			g_muxEdgeMask = g_muxMask[0];
+			g_muxEdgeLevel = g_muxMask[0];
+			return;
+		}
+
+		/* Rise of the next channel, right after the fall */
+		port = g_muxPort[channel];
+		*port |= g_muxMask[channel];
+		g_muxChannel = channel;
+		g_muxEdgePort = port;
+		g_muxEdgeMask = g_muxMask[channel];
+	}
+
+	/* Fall of the channel that just rose, the width is taken once per pulse */
+	OCR1B = (now - g_muxEdgeDelay) + g_muxWidth[channel];
+	g_muxEdgeLevel = 0;
+}
+
+#endif /* SERVO_MUX_ISR_H_ */
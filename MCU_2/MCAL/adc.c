@@ -11,9 +11,59 @@
  *******************************************************************************/
 
 #include "avr/io.h" /* To use the ADC Registers */
+#include <avr/interrupt.h> /* For the ADC ISR */
 #include "adc.h"
+#include "isr_config.h" /* For the handlers bound at compile time */
 #include "..\common_macros.h" /* To use the macros like SET_BIT */
 
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+/* Global variable to hold the address of the callback function in the application */
+static void (*volatile g_callBackPtr)(void) = NULL_PTR;
+
+/*
+ * A timer trigger only starts a conversion on the rising edge of its flag in
+ * TIFR, which the timer clears only while its own interrupt is enabled.
+ * g_triggerFlag is that flag, g_triggerEnable its enable bit in TIMSK, both 0
+ * for the other sources.
+ */
+static uint8 g_triggerFlag = 0;
+static uint8 g_triggerEnable = 0;
+
+/*******************************************************************************
+ *                      Private Functions Definitions                          *
+ *******************************************************************************/
+
+/* Clears the flag of a timer trigger nobody else clears, so the next event triggers again */
+static inline void ADC_rearmTrigger(void)
+{
+	if ((g_triggerFlag != 0) && ((TIMSK & g_triggerEnable) == 0))
+	{
+		TIFR = g_triggerFlag;
+	}
+}
+
+/*******************************************************************************
+ *                       Interrupt Service Routines                            *
+ *******************************************************************************/
+
+ISR(ADC_vect)
+{
+#ifdef ADC_HANDLER
+	/* Handler bound at compile time, inlined in the vector */
+	ADC_HANDLER();
+#else
+	if(g_callBackPtr != NULL_PTR)
+	{
+		/* Call the Callback function in the application when a conversion is complete */
+		(*g_callBackPtr)();
+	}
+#endif
+	ADC_rearmTrigger();
+}
+
 /*******************************************************************************
  *                      Functions Definitions                                  *
  *******************************************************************************/
@@ -36,13 +86,99 @@ void ADC_init(void)
 	ADCSRA = (1<<ADEN) | (1<<ADPS1) | (1<<ADPS0);
 }
 
+/*
+ * Description :
+ * The triggered conversions are paused while the channel is converted: the
+ * trigger and the interrupt are turned off, a conversion already started is
+ * let complete and dropped, then the channel and the trigger are restored.
+ */
 uint16 ADC_readChannel(uint8 channel_num)
 {
+	uint8 auto_trigger = ADCSRA & ((1<<ADATE) | (1<<ADIE));
+	uint8 mux = ADMUX;
+	uint16 result;
+
+	ADCSRA &= ~((1<<ADATE) | (1<<ADIE)); /* Pause the triggered conversions, this also clears a pending ADIF */
+	while(BIT_IS_SET(ADCSRA,ADSC)); /* Let a triggered conversion in progress complete */
+	SET_BIT(ADCSRA,ADIF); /* Drop its result, ADIF has to signal our own conversion */
+
 	channel_num &= 0x07; /* Input channel number must be from 0 --> 7 */
 	ADMUX &= 0xE0; /* Clear first 5 bits in the ADMUX (channel number MUX4:0 bits) before set the required channel */
 	ADMUX = ADMUX | channel_num; /* Choose the correct channel by setting the channel number in MUX4:0 bits */
 	SET_BIT(ADCSRA,ADSC); /* Start conversion write '1' to ADSC */
 	while(BIT_IS_CLEAR(ADCSRA,ADIF)); /* Wait for conversion to complete, ADIF becomes '1' */
 	SET_BIT(ADCSRA,ADIF); /* Clear ADIF by write '1' to it :) */
-	return ADC; /* Read the digital value from the data register */
+	result = ADC; /* Read the digital value from the data register */
+
+	if (auto_trigger)
+	{
+		ADMUX = mux;
+		ADC_rearmTrigger(); /* The flag may have risen during the pause */
+		ADCSRA |= auto_trigger;
+	}
+
+	return result;
+}
+
+void ADC_startAutoTrigger(uint8 channel_num, ADC_TriggerType trigger)
+{
+	ADC_stopAutoTrigger();
+
+	switch (trigger)
+	{
+	case ADC_TRIGGER_TIMER0_COMPARE:
+		g_triggerFlag = (1<<OCF0);
+		g_triggerEnable = (1<<OCIE0);
+		break;
+	case ADC_TRIGGER_TIMER0_OVERFLOW:
+		g_triggerFlag = (1<<TOV0);
+		g_triggerEnable = (1<<TOIE0);
+		break;
+	case ADC_TRIGGER_TIMER1_COMPARE_B:
+		g_triggerFlag = (1<<OCF1B);
+		g_triggerEnable = (1<<OCIE1B);
+		break;
+	case ADC_TRIGGER_TIMER1_OVERFLOW:
+		g_triggerFlag = (1<<TOV1);
+		g_triggerEnable = (1<<TOIE1);
+		break;
+	case ADC_TRIGGER_TIMER1_CAPTURE:
+		g_triggerFlag = (1<<ICF1);
+		g_triggerEnable = (1<<TICIE1);
+		break;
+	default:
+		g_triggerFlag = 0;
+		g_triggerEnable = 0;
+		break;
+	}
+
+	channel_num &= 0x07; /* Input channel number must be from 0 --> 7 */
+	ADMUX = (ADMUX & 0xE0) | channel_num;
+
+	/* ADTS2:0 in the 3 upper bits of SFIOR select the trigger source */
+	SFIOR = (SFIOR & 0x1F) | (trigger << ADTS0);
+
+	ADC_rearmTrigger();
+
+	/* ADATE = 1 start a conversion on each trigger, ADIE = 1 interrupt when it completes */
+	ADCSRA |= (1<<ADIF) | (1<<ADATE) | (1<<ADIE);
+
+	/* Free running needs a first conversion to start */
+	if (trigger == ADC_TRIGGER_FREE_RUNNING)
+	{
+		SET_BIT(ADCSRA,ADSC);
+	}
+}
+
+void ADC_stopAutoTrigger(void)
+{
+	ADCSRA &= ~((1<<ADATE) | (1<<ADIE));
+	g_triggerFlag = 0;
+	g_triggerEnable = 0;
+}
+
+void ADC_setCallBack(void(*a_ptr)(void))
+{
+	/* Save the address of the Call back function in a global variable */
+	g_callBackPtr = a_ptr;
 }
@@ -13,6 +13,7 @@
 #include "gpio.h"
 #include "..\common_macros.h" /* To use the macros like SET_BIT */
 #include "avr/io.h" /* To use the IO Ports Registers */
+#include <avr/interrupt.h> /* To use cli() */
 
 /*
  * Description :
@@ -84,60 +85,75 @@ void GPIO_setupPinDirection(uint8 port_num, uint8 pin_num, GPIO_PinDirectionType
  * Write the value Logic High or Logic Low on the required pin.
  * If the input port number or pin number are not correct, The function will not handle the request.
  * If the pin is input, this function will enable/disable the internal pull-up resistor.
+ * Interrupts also write pins (servo edges), so only the read-modify-write of the port is done with the
+ * interrupts off. The bit is computed before, its shift can take a loop.
  */
 void GPIO_writePin(uint8 port_num, uint8 pin_num, uint8 value)
 {
+	uint8 sreg;
+	uint8 bit;
+
 	if((pin_num >= NUM_OF_PINS_PER_PORT) || (port_num >= NUM_OF_PORTS))
 	{
 		/* Do Nothing */
 	}
 	else
 	{
+		bit = (uint8)(1 << pin_num);
+		sreg = SREG;
 		switch(port_num)
 		{
 		case PORTA_ID:
 			if(value == 0)
 			{
-				CLEAR_BIT(PORTA,pin_num);
+				cli();
+				PORTA &= ~bit;
 			}
 			else
 			{
-				SET_BIT(PORTA,pin_num);
+				cli();
+				PORTA |= bit;
 			}
 			break;
 		case PORTB_ID:
 			if(value == 0)
 			{
-				CLEAR_BIT(PORTB,pin_num);
+				cli();
+				PORTB &= ~bit;
 			}
 			else
 			{
-				SET_BIT(PORTB,pin_num);
+				cli();
+				PORTB |= bit;
 			}
 			break;
 		case PORTC_ID:
 			if(value == 0)
 			{
-				CLEAR_BIT(PORTC,pin_num);
+				cli();
+				PORTC &= ~bit;
 			}
 			else
 			{
-				SET_BIT(PORTC,pin_num);
+				cli();
+				PORTC |= bit;
 			}
 			break;
 		case PORTD_ID:
 			if(value == 0)
 			{
-				CLEAR_BIT(PORTD,pin_num);
+				cli();
+				PORTD &= ~bit;
 			}
 			else
 			{
-				SET_BIT(PORTD,pin_num);
+				cli();
+				PORTD |= bit;
 			}
 			break;
 
 		}
-
+		SREG = sreg;
 	}
 
 }
@@ -278,6 +294,45 @@ void GPIO_writePort(uint8 port_num, uint8 value)
 
 }
 
+/*
+ * Description :
+ * Write the value on the pins of the mask in the required port, the other pins keep their value.
+ * All the pins of the mask change together in a single write of the port.
+ * If the input port number is not correct, The function will not handle the request.
+ * Interrupts also write pins, so the read-modify-write is done with the interrupts off.
+ */
+void GPIO_writeMasked(uint8 port_num, uint8 mask, uint8 value)
+{
+	uint8 sreg;
+
+	if(port_num >= NUM_OF_PORTS)
+	{
+		/* Do Nothing */
+	}
+	else
+	{
+		value &= mask;
+		sreg = SREG;
+		cli();
+		switch(port_num)
+		{
+		case PORTA_ID:
+			PORTA = (PORTA & ~mask) | value;
+			break;
+		case PORTB_ID:
+			PORTB = (PORTB & ~mask) | value;
+			break;
+		case PORTC_ID:
+			PORTC = (PORTC & ~mask) | value;
+			break;
+		case PORTD_ID:
+			PORTD = (PORTD & ~mask) | value;
+			break;
+		}
+		SREG = sreg;
+	}
+}
+
 /*
  * Description :
  * Read and return the value of the required port.
@@ -92,6 +92,14 @@ void GPIO_setupPortDirection(uint8 port_num, GPIO_PortDirectionType direction);
  */
 void GPIO_writePort(uint8 port_num, uint8 value);
 
+/*
+ * Description :
+ * Write the value on the pins of the mask in the required port, the other pins keep their value.
+ * All the pins of the mask change together in a single write of the port.
+ * If the input port number is not correct, The function will not handle the request.
+ */
+void GPIO_writeMasked(uint8 port_num, uint8 mask, uint8 value);
+
 /*
  * Description :
  * Read and return the value of the required port.
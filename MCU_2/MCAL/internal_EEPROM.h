@@ -0,0 +1,96 @@
+/******************************************************************************
+ *
+ * Module: Internal EEPROM
+ *
+ * File Name: internal_EEPROM.h
+ *
+ * Description: Header file for the internal EEPROM driver
+ *
+ * Author: Mohamed Hisham
+ *
+ *******************************************************************************/
+
+#ifndef INTERNAL_EEPROM_H_
+#define INTERNAL_EEPROM_H_
+
+#include "..\std_types.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* Number of bytes that can wait in the non-blocking write queue */
+#define INTERNAL_EEPROM_WRITE_QUEUE_SIZE	32
+
+/*******************************************************************************
+ *                              Functions Prototypes                           *
+ *******************************************************************************/
+
+/******************************************************************************
+ * Service Name: INTERNAL_EEPROM_writeByte
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-reentrant
+ * Parameters (in): Address - The memory address to write to within the EEPROM
+ *                  Data - The byte of data to be written to the specified address
+ * Parameters (inout): None
+ * Parameters (out): None
+ * Return value: None
+ * Description: Writes a single byte of data to a specified address in the internal EEPROM.
+ *******************************************************************************/
+void INTERNAL_EEPROM_writeByte(uint16 Address, uint8 Data);
+
+/******************************************************************************
+ * Service Name: INTERNAL_EEPROM_readByte
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-reentrant
+ * Parameters (in): Address - The memory address to read from within the EEPROM
+ * Parameters (inout): None
+ * Parameters (out): None
+ * Return value: uint8 - The byte of data read from the specified address
+ * Description: Reads a single byte of data from a specified address in the internal EEPROM.
+ *******************************************************************************/
+uint8 INTERNAL_EEPROM_readByte(uint16 Address);
+
+/******************************************************************************
+ * Service Name: INTERNAL_EEPROM_writeBlockAsync
+ * Sync/Async: Asynchronous
+ * Reentrancy: Reentrant
+ * Parameters (in): Address - The first EEPROM address of the block
+ *                  Data_Ptr - Pointer to the bytes to be written
+ *                  Size - Number of bytes to write
+ * Parameters (inout): None
+ * Parameters (out): None
+ * Return value: boolean - TRUE if the whole block was queued, FALSE if the
+ *                         queue has no room for it (nothing is queued)
+ * Description: Copies the block into the write queue and returns immediately.
+ *              The bytes are programmed one by one from the EEPROM ready
+ *              interrupt, so the caller never waits for the ~8.5ms write time.
+ *******************************************************************************/
+boolean INTERNAL_EEPROM_writeBlockAsync(uint16 Address, const uint8 *Data_Ptr, uint8 Size);
+
+/******************************************************************************
+ * Service Name: INTERNAL_EEPROM_readBlock
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-reentrant
+ * Parameters (in): Address - The first EEPROM address of the block
+ *                  Size - Number of bytes to read
+ * Parameters (inout): None
+ * Parameters (out): Data_Ptr - Buffer that receives the bytes
+ * Return value: None
+ * Description: Reads a block of consecutive bytes from the internal EEPROM.
+ *******************************************************************************/
+void INTERNAL_EEPROM_readBlock(uint16 Address, uint8 *Data_Ptr, uint8 Size);
+
+/******************************************************************************
+ * Service Name: INTERNAL_EEPROM_isBusy
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters (in): None
+ * Parameters (inout): None
+ * Parameters (out): None
+ * Return value: boolean - TRUE while queued bytes are still being written
+ * Description: Reports whether the non-blocking write path still has work to do.
+ *******************************************************************************/
+boolean INTERNAL_EEPROM_isBusy(void);
+
+#endif /* INTERNAL_EEPROM_H_ */
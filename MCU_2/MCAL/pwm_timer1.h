@@ -0,0 +1,60 @@
+ /*******************************************************************************
+ * Module: timer1
+ *
+ * File Name: pwm_timer1.h
+ *
+ * Description: header file for PWM timer1
+ *
+ * Author: Mohamed Hisham
+ *
+ *******************************************************************************/
+
+#ifndef PWM_TIMER1_H_
+#define PWM_TIMER1_H_
+
+#include "..\std_types.h"
+#include "timer1.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* Duty cycles are given in permille, 1000 is always on */
+#define PWM_TIMER1_DUTY_MAX		1000
+
+/* Frequency of the 4-wire fan PWM input */
+#define PWM_TIMER1_FAN_FREQUENCY	25000UL
+
+/*******************************************************************************
+ *                              Functions Prototypes                           *
+ *******************************************************************************/
+
+/*
+ * Description:
+ * Generate phase correct PWM signals on OC1A (PD5) and OC1B (PD4) with the TOP
+ * in ICR1, both channels share the frequency.
+ * Timer1 will be used without pre-scaler
+ * F_PWM=(F_CPU)/(2*TOP) --> TOP=(F_CPU)/(2*F_PWM)
+ * The duty resolution is 1/TOP: at 1MHz 25kHz gives TOP=20 (5% steps), below
+ * 5kHz TOP goes over 100 and the steps get finer than 1%.
+ * Timer1 is taken for itself, it cannot be shared with input capture.
+ * The outputs start at 0% duty, a pin only drives once its channel is enabled.
+ */
+void PWM_Timer1_Init(uint32 frequency);
+
+/*
+ * Description:
+ * Set the pin of a channel as output, so the PWM signal reaches it.
+ */
+void PWM_Timer1_enableChannel(Timer1_Channel channel);
+
+/*
+ * Description:
+ * Change the duty cycle (0 to PWM_TIMER1_DUTY_MAX permille) of a channel while
+ * the timer keeps running. The compare register is only written when the value
+ * changes, the new value takes effect at the next TOP. 0% disconnects the
+ * output at once and leaves the pin low.
+ */
+void PWM_Timer1_setDuty(Timer1_Channel channel, uint16 duty_cycle);
+
+#endif /* PWM_TIMER1_H_ */
@@ -0,0 +1,49 @@
+ /*******************************************************************************
+ * Module: timer2
+ *
+ * File Name: pwm_timer2.h
+ *
+ * Description: header file for PWM timer2
+ *
+ * Author: Mohamed Hisham
+ *
+ *******************************************************************************/
+
+#ifndef PWM_TIMER2_H_
+#define PWM_TIMER2_H_
+
+#include "..\std_types.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* Duty cycles are given in permille, 1000 is always on */
+#define PWM_TIMER2_DUTY_MAX		1000
+
+/* 255/1000 in Q16, turns a duty cycle into a compare value without a division */
+#define PWM_TIMER2_DUTY_SCALE	16712UL
+
+/*******************************************************************************
+ *                              Functions Prototypes                           *
+ *******************************************************************************/
+
+/*
+ * Description:
+ * Generate a PWM signal on OC2 (PD7) from the Timer2 of the system time base.
+ * Timer2 is switched to fast PWM mode, it still counts 0 to 255 with the same
+ * pre-scaler, so the overflow tick of the time base does not change.
+ * F_PWM=(F_CPU)/(256*N) = (10^6)/(256*32) = 122Hz
+ * To be called after Time_init, the output starts at 0% duty.
+ */
+void PWM_Timer2_Init(void);
+
+/*
+ * Description:
+ * Change the duty cycle (0 to PWM_TIMER2_DUTY_MAX permille) while the timer
+ * keeps running. OCR2 is only written when the value changes, the new value
+ * takes effect at the end of the current PWM period.
+ */
+void PWM_Timer2_setDuty(uint16 duty_cycle);
+
+#endif /* PWM_TIMER2_H_ */
@@ -12,15 +12,58 @@
 
 #include "timer1.h"
 #include <avr/io.h> /* To use ICU/Timer1 Registers */
-#include <avr/interrupt.h> /* For ICU ISR */\
+#include <avr/interrupt.h> /* For ICU ISR */
+#include "isr_config.h" /* For the handlers bound at compile time */
 
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+#define TIMER1_INTERRUPTS_MASK	((1<<TICIE1) | (1<<OCIE1A) | (1<<OCIE1B) | (1<<TOIE1))
+
+/* Interrupts of the vectors bound at compile time, always enabled by Timer1_init */
+#ifdef TIMER1_OVF_HANDLER
+#define TIMER1_OVF_BOUND		(1<<TOIE1)
+#else
+#define TIMER1_OVF_BOUND		0
+#endif
+
+#ifdef TIMER1_COMPA_HANDLER
+#define TIMER1_COMPA_BOUND		(1<<OCIE1A)
+#else
+#define TIMER1_COMPA_BOUND		0
+#endif
+
+#ifdef TIMER1_COMPB_HANDLER
+#define TIMER1_COMPB_BOUND		(1<<OCIE1B)
+#else
+#define TIMER1_COMPB_BOUND		0
+#endif
+
+#ifdef TIMER1_CAPT_HANDLER
+#define TIMER1_CAPT_BOUND		(1<<TICIE1)
+#else
+#define TIMER1_CAPT_BOUND		0
+#endif
+
+#define TIMER1_BOUND_INTERRUPTS	(TIMER1_OVF_BOUND | TIMER1_COMPA_BOUND | TIMER1_COMPB_BOUND | TIMER1_CAPT_BOUND)
 
 /*******************************************************************************
  *                           Global Variables                                  *
  *******************************************************************************/
 
-/* Global variables to hold the address of the call back function in the application */
-static volatile void (*g_callBackPtr)(void) = ((void*)0);
+/* Global variables to hold the address of the callback function of each event in the application */
+static void (*volatile g_callBackPtr[TIMER1_EVENTS_COUNT])(void) = {
+	NULL_PTR, NULL_PTR, NULL_PTR, NULL_PTR
+};
+
+/* Interrupt enable and flag bits of each event, in Timer1_Event order */
+static const uint8 g_interruptEnable[TIMER1_EVENTS_COUNT] = {
+	(1<<TOIE1), (1<<OCIE1A), (1<<OCIE1B), (1<<TICIE1)
+};
+static const uint8 g_interruptFlag[TIMER1_EVENTS_COUNT] = {
+	(1<<TOV1), (1<<OCF1A), (1<<OCF1B), (1<<ICF1)
+};
 
 /*******************************************************************************
  *                       Interrupt Service Routines                            *
@@ -28,94 +71,208 @@ static volatile void (*g_callBackPtr)(void) = ((void*)0);
 
 ISR(TIMER1_OVF_vect)
 {
-	if(g_callBackPtr != ((void*)0))
+#ifdef TIMER1_OVF_HANDLER
+	/* Handler bound at compile time, inlined in the vector */
+	TIMER1_OVF_HANDLER();
+#else
+	if(g_callBackPtr[TIMER1_OVERFLOW_EVENT] != NULL_PTR)
 	{
-		/* Call the Call Back function in the application after overflow*/
-		(*g_callBackPtr)(); /* another method to call the function using pointer to function g_callBackPtr(); */
+		/* Call the Callback function in the application after overflow */
+		(*g_callBackPtr[TIMER1_OVERFLOW_EVENT])();
 	}
+#endif
 }
 
 ISR(TIMER1_COMPA_vect)
 {
-	if(g_callBackPtr != ((void*)0))
+#ifdef TIMER1_COMPA_HANDLER
+	/* Handler bound at compile time, inlined in the vector */
+	TIMER1_COMPA_HANDLER();
+#else
+	if(g_callBackPtr[TIMER1_COMPARE_A_EVENT] != NULL_PTR)
+	{
+		/* Call the Callback function in the application after reaching the channel A compare value */
+		(*g_callBackPtr[TIMER1_COMPARE_A_EVENT])();
+	}
+#endif
+}
+
+ISR(TIMER1_COMPB_vect)
+{
+#ifdef TIMER1_COMPB_HANDLER
+	/* Handler bound at compile time, inlined in the vector */
+	TIMER1_COMPB_HANDLER();
+#else
+	if(g_callBackPtr[TIMER1_COMPARE_B_EVENT] != NULL_PTR)
+	{
+		/* Call the Callback function in the application after reaching the channel B compare value */
+		(*g_callBackPtr[TIMER1_COMPARE_B_EVENT])();
+	}
+#endif
+}
+
+ISR(TIMER1_CAPT_vect)
+{
+#ifdef TIMER1_CAPT_HANDLER
+	/* Handler bound at compile time, inlined in the vector */
+	TIMER1_CAPT_HANDLER();
+#else
+	if(g_callBackPtr[TIMER1_CAPTURE_EVENT] != NULL_PTR)
 	{
-		/* Call the Call Back function in the application after reaching the compare value*/
-		(*g_callBackPtr)(); /* another method to call the function using pointer to function g_callBackPtr(); */
+		/* Call the Callback function in the application after a capture edge */
+		(*g_callBackPtr[TIMER1_CAPTURE_EVENT])();
 	}
+#endif
 }
 
 /*******************************************************************************
  *                      Functions Definitions                                  *
  *******************************************************************************/
 
-/*
- * Description
- 	 * Function to initialize the Timer driver
-* Inputs: pointer to the configuration structure with type Timer1_ConfigType.
-* Return: None
- */
-void Timer1_init(const Timer1_ConfigType * Config_Ptr){
+void Timer1_init(const Timer1_ConfigType * Config_Ptr)
+{
+	uint8 interrupts = TIMER1_BOUND_INTERRUPTS;
+	uint8 event;
 
-	TCCR1A = (1<<FOC1A);
-	TCCR1B = (Config_Ptr->mode<<WGM12);
-	TCCR1B |= (Config_Ptr->prescaler);
+	/* Null pointer check */
+	if (Config_Ptr == NULL_PTR)
+	{
+		return;
+	}
+
+	/* Stop the timer while it is configured */
+	TCCR1B = 0;
+
+	/* Configure the compare outputs */
+	TCCR1A = (Config_Ptr->output_a << COM1A0) | (Config_Ptr->output_b << COM1B0);
+
+	/* Set Timer1 initial and compare values */
 	TCNT1 = Config_Ptr->initial_value;
+	OCR1A = Config_Ptr->compare_value;
+	OCR1B = Config_Ptr->compare_b_value;
 
-	if(Config_Ptr->mode)
+	switch (Config_Ptr->mode)
 	{
-		OCR1A = Config_Ptr->compare_value;
-		TIMSK = (1<<OCIE1A);
+	case COMPARE_MODE:
+		/* CTC with the TOP in OCR1A (Mode Number 4) */
+		TCCR1B = (1<<WGM12);
+		break;
+	case FAST_PWM_MODE:
+		/* Fast PWM with the TOP in ICR1 (Mode Number 14) */
+		ICR1 = Config_Ptr->top_value;
+		TCCR1A |= (1<<WGM11);
+		TCCR1B = (1<<WGM12) | (1<<WGM13);
+		break;
+	case PHASE_CORRECT_PWM_MODE:
+		/* Phase correct PWM with the TOP in ICR1 (Mode Number 10) */
+		ICR1 = Config_Ptr->top_value;
+		TCCR1A |= (1<<WGM11);
+		TCCR1B = (1<<WGM13);
+		break;
+	case INPUT_CAPTURE_MODE:
+		/* Normal counting, noise canceler on and the selected capture edge */
+		TCCR1B = (1<<ICNC1) | (Config_Ptr->capture_edge << ICES1);
+		break;
+	default:
+		break;
 	}
-	else
+
+	/* Clear any pending interrupts, then enable the bound ones and the ones that have a callback */
+	TIFR = (1<<ICF1) | (1<<OCF1A) | (1<<OCF1B) | (1<<TOV1);
+	for (event = 0; event < TIMER1_EVENTS_COUNT; event++)
 	{
-		TIMSK = (1<<TOIE1);
+		if (g_callBackPtr[event] != NULL_PTR)
+		{
+			interrupts |= g_interruptEnable[event];
+		}
 	}
-}
+	/* Only touch the Timer1 bits, the other timers share TIMSK */
+	TIMSK = (TIMSK & ~TIMER1_INTERRUPTS_MASK) | interrupts;
 
-void Timer1_Fast_PWM_Init(unsigned short duty_cycle)
-{
-	TCNT1 = 0;		/* Set timer1 initial count to zero */
-	ICR1 = 2499;	/* Set TOP count for timer1 in ICR1 register */
-
-	OCR1A = duty_cycle; /* Set the compare value */
-
-	/* Configure timer control register TCCR1A
-     * 1. Clear OC1A on compare match (non inverting mode) COM1A1=1 COM1A0=0
-     * 2. Disconnect OC1B  COM1B0=0 COM1B1=0
-     * 3. FOC1A=0 FOC1B=0 because these bits are only active in case non-pwm mode
-     * 4. Fast Pwm Mode with the TOP in ICR1 WGM10=0 WGM11=1 (Mode Number 14)
-	 */
-	TCCR1A = (1<<WGM11) | (1<<COM1A1);
-
-	/* Configure timer control register TCCR1B
-	 * 1. Fast Pwm Mode with the TOP in ICR1 WGM12=1 WGM13=1 (Mode Number 14)
-	 * 2. Prescaler = F_CPU/8
-     */
-	TCCR1B = (1<<WGM12) | (1<<WGM13) | (1<<CS11);
+	/* Start the timer */
+	TCCR1B |= (Config_Ptr->prescaler);
 }
 
-/*
- * Description
- 	 * Function to disable the Timer1.
-* Inputs: None
-* Return: None
- */
-void Timer1_deInit(void){
+void Timer1_deInit(void)
+{
+	/* Disable Timer1 and clear all its registers */
 	TCCR1A = 0;
 	TCCR1B = 0;
 	TCNT1 = 0;
 	OCR1A = 0;
-	TIMSK = 0;
+	OCR1B = 0;
+	ICR1 = 0;
+
+	/* Disable Timer1 Interrupts */
+	TIMSK &= ~TIMER1_INTERRUPTS_MASK;
 }
 
-/*
- * Description
- 	 *Function to set the Call Back function address.
-* Inputs: pointer to Call Back function.
-* Return: None
- */
-void Timer1_setCallBack(void(*a_ptr)(void)){
+void Timer1_setCallBack(Timer1_Event event, void(*a_ptr)(void))
+{
+	uint8 sreg = SREG;
+
+	if (event >= TIMER1_EVENTS_COUNT)
+	{
+		return;
+	}
+
+	cli();
+	/* Save the address of the Callback function in a global variable */
+	g_callBackPtr[event] = a_ptr;
+
+	if (a_ptr != NULL_PTR)
+	{
+		/* Drop an old pending event before enabling its interrupt */
+		TIFR = g_interruptFlag[event];
+		TIMSK |= g_interruptEnable[event];
+	}
+	else
+	{
+		TIMSK &= ~g_interruptEnable[event];
+	}
+	SREG = sreg;
+}
+
+void Timer1_setCompareValue(Timer1_Channel channel, uint16 value)
+{
+	uint8 sreg = SREG;
+
+	/* The 16-bit registers share one temporary byte with the ISRs */
+	cli();
+	if (channel == TIMER1_CHANNEL_A)
+	{
+		OCR1A = value;
+	}
+	else
+	{
+		OCR1B = value;
+	}
+	SREG = sreg;
+}
+
+void Timer1_setCaptureEdge(Timer1_CaptureEdge edge)
+{
+	if (edge == CAPTURE_RISING_EDGE)
+	{
+		TCCR1B |= (1<<ICES1);
+	}
+	else
+	{
+		TCCR1B &= ~(1<<ICES1);
+	}
+
+	/* Changing the edge can set the capture flag */
+	TIFR = (1<<ICF1);
+}
+
+uint16 Timer1_getCaptureValue(void)
+{
+	uint16 value;
+	uint8 sreg = SREG;
+
+	cli();
+	value = ICR1;
+	SREG = sreg;
 
-	/* Save the address of the Call back function in a global variable */
-		g_callBackPtr = a_ptr;
+	return value;
 }
@@ -22,17 +22,50 @@
 typedef enum{
 	NO_CLOCK, PRESCALER_1, PRESCALER_8, PRESCALER_64, PRESCALER_256, PRESCALER_1024,
 	EXTERNAL_FALLING_EDGE, EXTERNAL_RISING_EDGE
-}Timer1_Prescaler;
+} Timer1_Prescaler;
+
+/*
+ * NORMAL_MODE: counts up to 0xFFFF.
+ * COMPARE_MODE: CTC, clears the count when it reaches the channel A compare value.
+ * FAST_PWM_MODE: fast PWM with the TOP in ICR1 (top_value).
+ * PHASE_CORRECT_PWM_MODE: phase correct PWM with the TOP in ICR1 (top_value),
+ *                         half the frequency of fast PWM for the same TOP.
+ * INPUT_CAPTURE_MODE: counts up to 0xFFFF and captures the count in ICR1 on
+ *                     each capture_edge of the ICP1 pin (PD6).
+ */
+typedef enum{
+	NORMAL_MODE, COMPARE_MODE, FAST_PWM_MODE, INPUT_CAPTURE_MODE, PHASE_CORRECT_PWM_MODE
+} Timer1_Mode;
+
+/* Compare output modes of OC1A (PD5) and OC1B (PD4), in PWM mode CLEAR is the non-inverting output */
+typedef enum{
+	OUTPUT_DISCONNECTED, OUTPUT_TOGGLE, OUTPUT_CLEAR, OUTPUT_SET
+} Timer1_OutputMode;
+
+typedef enum{
+	CAPTURE_FALLING_EDGE, CAPTURE_RISING_EDGE
+} Timer1_CaptureEdge;
 
 typedef enum{
-	NORMAL_MODE, COMPARE_MODE
-}Timer1_Mode;
+	TIMER1_CHANNEL_A, TIMER1_CHANNEL_B
+} Timer1_Channel;
+
+/* Each event has its own interrupt vector and callback */
+typedef enum{
+	TIMER1_OVERFLOW_EVENT, TIMER1_COMPARE_A_EVENT, TIMER1_COMPARE_B_EVENT, TIMER1_CAPTURE_EVENT,
+	TIMER1_EVENTS_COUNT
+} Timer1_Event;
 
 typedef struct {
-uint16 initial_value;
-uint16 compare_value; // it will be used in compare mode only.
-Timer1_Prescaler prescaler;
-Timer1_Mode mode;
+	uint16 initial_value;
+	uint16 compare_value; // Channel A compare value, it is the TOP in compare mode.
+	uint16 compare_b_value; // Channel B compare value.
+	uint16 top_value; // It will be used in the PWM modes only.
+	Timer1_Prescaler prescaler;
+	Timer1_Mode mode;
+	Timer1_OutputMode output_a;
+	Timer1_OutputMode output_b;
+	Timer1_CaptureEdge capture_edge; // It will be used in input capture mode only.
 } Timer1_ConfigType;
 
 /*******************************************************************************
@@ -40,37 +73,55 @@ Timer1_Mode mode;
  *******************************************************************************/
 
 /*
- * Description
- 	 * Function to initialize the Timer driver
-* Inputs: pointer to the configuration structure with type Timer1_ConfigType.
-* Return: None
+ * Description:
+ * Function to initialize the Timer driver. The interrupts of the events that
+ * have a callback or a handler bound in isr_config.h are enabled.
+ * Inputs: pointer to the configuration structure with type Timer1_ConfigType.
+ * Return: None
  */
 void Timer1_init(const Timer1_ConfigType * Config_Ptr);
 
+/*
+ * Description:
+ * Function to disable the Timer1. The callbacks are kept for the next Timer1_init.
+ * Inputs: None
+ * Return: None
+ */
+void Timer1_deInit(void);
 
 /*
- * Description
- 	 * Function to initialize the Timer driver as Fast PWM generator
-* Inputs: None
-* Return: None
+ * Description:
+ * Function to set the Callback function address of one event. The interrupt
+ * of the event is enabled, or disabled if the address is NULL_PTR. It has no
+ * effect on the dispatch of an event bound in isr_config.h.
+ * Inputs: the event and pointer to Callback function.
+ * Return: None
  */
-void Timer1_Fast_PWM_Init(unsigned short duty_cycle);
+void Timer1_setCallBack(Timer1_Event event, void(*a_ptr)(void));
 
 /*
- * Description
- 	 * Function to disable the Timer1.
-* Inputs: None
-* Return: None
+ * Description:
+ * Function to change the compare value of one channel while the timer runs.
+ * In PWM mode the new value takes effect at the next TOP.
+ * Inputs: the channel and the new compare value.
+ * Return: None
  */
-void Timer1_deInit(void);
+void Timer1_setCompareValue(Timer1_Channel channel, uint16 value);
 
 /*
- * Description
- 	 *Function to set the Call Back function address.
-* Inputs: pointer to Call Back function.
-* Return: None
+ * Description:
+ * Function to change the edge that triggers the input capture.
+ * Inputs: the capture edge.
+ * Return: None
  */
-void Timer1_setCallBack(void(*a_ptr)(void));
+void Timer1_setCaptureEdge(Timer1_CaptureEdge edge);
 
+/*
+ * Description:
+ * Function to read the count captured at the last capture edge.
+ * Inputs: None
+ * Return: the captured count.
+ */
+uint16 Timer1_getCaptureValue(void);
 
 #endif /* TIMER1_H_ */
@@ -0,0 +1,111 @@
+ /******************************************************************************
+ *
+ * Module: Timer2
+ *
+ * File Name: timer2.c
+ *
+ * Description: Source file for Timer2
+ *
+ * Author: Mohamed Hisham
+ *
+ *******************************************************************************/
+
+#include "timer2.h"
+#include <avr/io.h> /* To use Timer2 Registers */
+#include <avr/interrupt.h> /* For Timer2 ISR */
+#include "isr_config.h" /* For the handlers bound at compile time */
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+/* Global variable to hold the address of the callback function in the application */
+static void (*volatile g_callBackPtr)(void) = NULL_PTR;
+
+/*******************************************************************************
+ *                       Interrupt Service Routines                            *
+ *******************************************************************************/
+
+ISR(TIMER2_OVF_vect)
+{
+#ifdef TIMER2_OVF_HANDLER
+	/* Handler bound at compile time, inlined in the vector */
+	TIMER2_OVF_HANDLER();
+#else
+	if(g_callBackPtr != NULL_PTR)
+	{
+		/* Call the Callback function in the application after overflow */
+		(*g_callBackPtr)();
+	}
+#endif
+}
+
+ISR(TIMER2_COMP_vect)
+{
+#ifdef TIMER2_COMP_HANDLER
+	/* Handler bound at compile time, inlined in the vector */
+	TIMER2_COMP_HANDLER();
+#else
+	if(g_callBackPtr != NULL_PTR)
+	{
+		/* Call the Callback function in the application after reaching the compare value */
+		(*g_callBackPtr)();
+	}
+#endif
+}
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+void Timer2_init(const Timer2_ConfigType * Config_Ptr)
+{
+	/* Null pointer check */
+	if (Config_Ptr == NULL_PTR)
+	{
+		return;
+	}
+
+	/* Configure Timer2 Control Register, non PWM mode and OC2 disconnected */
+	TCCR2 = (1<<FOC2) | (Config_Ptr->mode << WGM21) | (Config_Ptr->prescaler);
+
+	/* Set Timer2 initial value */
+	TCNT2 = Config_Ptr->initial_value;
+
+	/* Only touch the Timer2 bits, the other timers share TIMSK */
+	TIMSK &= ~((1<<OCIE2) | (1<<TOIE2));
+
+	if (Config_Ptr->mode == TIMER2_COMPARE_MODE)
+	{
+		/* Set compare value */
+		OCR2 = Config_Ptr->compare_value;
+
+		/* Enable Compare Match Interrupt */
+		TIMSK |= (1<<OCIE2);
+	}
+	else
+	{
+		/* Enable Overflow Interrupt */
+		TIMSK |= (1<<TOIE2);
+	}
+
+	/* Clear any pending interrupts */
+	TIFR = (1<<OCF2) | (1<<TOV2);
+}
+
+void Timer2_deInit(void)
+{
+	/* Disable Timer2 and clear all its registers */
+	TCCR2 = 0;
+	TCNT2 = 0;
+	OCR2 = 0;
+
+	/* Disable Timer2 Interrupts */
+	TIMSK &= ~((1<<OCIE2) | (1<<TOIE2));
+}
+
+void Timer2_setCallBack(void(*a_ptr)(void))
+{
+	/* Save the address of the Callback function in a global variable */
+	g_callBackPtr = a_ptr;
+}
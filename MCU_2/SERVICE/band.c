@@ -0,0 +1,132 @@
+ /******************************************************************************
+ *
+ * Module: Band Classifier
+ *
+ * File Name: band.c
+ *
+ * Description: Source file for the band classifier, splits a noisy value into
+ *              bands with hysteresis and a minimum dwell time per threshold
+ *
+ * Author: Mohamed Hisham
+ *
+ *******************************************************************************/
+
+#include "band.h"
+#include "timebase.h"
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+/******************************************************************************
+ * Service Name: Band_init
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters (in): thresholds - Rising thresholds, kept by the classifier
+ *                  count - Number of thresholds
+ * Parameters (inout): band_ptr - The classifier
+ * Parameters (out): None
+ * Return value: None
+ * Description: Sets the thresholds, the first update then takes the band of the
+ *              value at once. The thresholds may be changed in place later,
+ *              the band in use is kept.
+ *******************************************************************************/
+void Band_init(Band_ClassifierType *band_ptr, const Band_ThresholdType *thresholds, uint8 count)
+{
+	band_ptr->thresholds = thresholds;
+	band_ptr->count = count;
+	band_ptr->band = 0;
+	band_ptr->candidate = 0;
+	band_ptr->candidateTime = 0;
+	band_ptr->started = FALSE;
+}
+
+/******************************************************************************
+ * Service Name: Band_update
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters (in): value - The new sample
+ * Parameters (inout): band_ptr - The classifier
+ * Parameters (out): None
+ * Return value: uint8 - The band in use
+ * Description: The band the value is in is searched from the band in use, so
+ *              the hysteresis only applies on the way down. A value moving on
+ *              to a further band in the same direction keeps the time already
+ *              waited, a value going back or to the other side restarts it.
+ *******************************************************************************/
+uint8 Band_update(Band_ClassifierType *band_ptr, uint8 value)
+{
+	const Band_ThresholdType *thresholds = band_ptr->thresholds;
+	uint32 now = Time_nowMs();
+	uint8 target = band_ptr->started ? band_ptr->band : 0;
+	uint16 dwell;
+	uint8 i;
+	uint8 last;
+
+	while ((target < band_ptr->count) && (value >= thresholds[target].threshold))
+	{
+		target++;
+	}
+
+	if (!band_ptr->started)
+	{
+		/* No history yet, take the band of the value as it is */
+		band_ptr->band = target;
+		band_ptr->candidate = target;
+		band_ptr->started = TRUE;
+		return target;
+	}
+
+	while ((target > 0) &&
+			(((uint16)value + thresholds[target - 1].hysteresis) < thresholds[target - 1].threshold))
+	{
+		target--;
+	}
+
+	if (target == band_ptr->band)
+	{
+		band_ptr->candidate = target;
+		return target;
+	}
+
+	if ((band_ptr->candidate == band_ptr->band) ||
+			((target > band_ptr->band) != (band_ptr->candidate > band_ptr->band)))
+	{
+		band_ptr->candidateTime = now;
+	}
+	band_ptr->candidate = target;
+
+	/* Shortest dwell time of the thresholds crossed, thresholds[i] lies between bands i and i + 1 */
+	i = (target > band_ptr->band) ? band_ptr->band : target;
+	last = (target > band_ptr->band) ? target : band_ptr->band;
+	dwell = thresholds[i].dwellMs;
+	for (i++; i < last; i++)
+	{
+		if (thresholds[i].dwellMs < dwell)
+		{
+			dwell = thresholds[i].dwellMs;
+		}
+	}
+
+	if (TIME_ELAPSED(now, band_ptr->candidateTime) >= dwell)
+	{
+		band_ptr->band = target;
+	}
+
+	return band_ptr->band;
+}
+
+/******************************************************************************
+ * Service Name: Band_get
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters (in): band_ptr - The classifier
+ * Parameters (inout): None
+ * Parameters (out): None
+ * Return value: uint8 - The band in use
+ * Description: Returns the band in use without a new sample.
+ *******************************************************************************/
+uint8 Band_get(const Band_ClassifierType *band_ptr)
+{
+	return band_ptr->band;
+}
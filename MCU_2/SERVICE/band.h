@@ -0,0 +1,85 @@
+ /******************************************************************************
+ *
+ * Module: Band Classifier
+ *
+ * File Name: band.h
+ *
+ * Description: Header file for the band classifier, splits a noisy value into
+ *              bands with hysteresis and a minimum dwell time per threshold
+ *
+ * Author: Mohamed Hisham
+ *
+ *******************************************************************************/
+
+#ifndef BAND_H_
+#define BAND_H_
+
+#include "..\std_types.h"
+
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+
+typedef struct {
+	uint8 threshold;              /* First value of the band above */
+	uint8 hysteresis;             /* The band above is left below threshold - hysteresis */
+	uint16 dwellMs;               /* Time the value has to stay across before the band changes */
+} Band_ThresholdType;
+
+typedef struct {
+	const Band_ThresholdType *thresholds; /* Rising thresholds, band i is below thresholds[i] */
+	uint8 count;                  /* Thresholds, the bands are 0 to count */
+	uint8 band;                   /* Band in use */
+	uint8 candidate;              /* Band the value is in, waiting for the dwell time */
+	uint32 candidateTime;         /* Time in ms the value entered the candidate band */
+	boolean started;              /* FALSE until the first update */
+} Band_ClassifierType;
+
+/*******************************************************************************
+ *                              Functions Prototypes                           *
+ *******************************************************************************/
+
+/******************************************************************************
+ * Service Name: Band_init
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters (in): thresholds - Rising thresholds, kept by the classifier
+ *                  count - Number of thresholds
+ * Parameters (inout): band_ptr - The classifier
+ * Parameters (out): None
+ * Return value: None
+ * Description: Sets the thresholds, the first update then takes the band of the
+ *              value at once. The thresholds may be changed in place later,
+ *              the band in use is kept.
+ *******************************************************************************/
+void Band_init(Band_ClassifierType *band_ptr, const Band_ThresholdType *thresholds, uint8 count);
+
+/******************************************************************************
+ * Service Name: Band_update
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters (in): value - The new sample
+ * Parameters (inout): band_ptr - The classifier
+ * Parameters (out): None
+ * Return value: uint8 - The band in use
+ * Description: Moves up when the value reaches a threshold and down when it
+ *              falls below the threshold minus its hysteresis. The move only
+ *              happens once the value stayed in the new band for the shortest
+ *              dwell time of the thresholds crossed, a sample back in the band
+ *              in use restarts the wait.
+ *******************************************************************************/
+uint8 Band_update(Band_ClassifierType *band_ptr, uint8 value);
+
+/******************************************************************************
+ * Service Name: Band_get
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters (in): band_ptr - The classifier
+ * Parameters (inout): None
+ * Parameters (out): None
+ * Return value: uint8 - The band in use
+ * Description: Returns the band in use without a new sample.
+ *******************************************************************************/
+uint8 Band_get(const Band_ClassifierType *band_ptr);
+
+#endif /* BAND_H_ */
@@ -0,0 +1,143 @@
+ /******************************************************************************
+ *
+ * Module: Link
+ *
+ * File Name: link.c
+ *
+ * Description: Source file for the frames sent from MCU1 to MCU2, shared by
+ *              both MCUs
+ *
+ * Author: Mohamed Hisham
+ *
+ *******************************************************************************/
+
+#include "link.h"
+#include "../MCAL/uart.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* Receiver states, the next byte expected */
+#define LINK_WAIT_START			0
+#define LINK_WAIT_TYPE			1
+#define LINK_WAIT_LENGTH		2
+#define LINK_WAIT_PAYLOAD		3
+#define LINK_WAIT_CHECKSUM		4
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+/******************************************************************************
+ * Service Name: Link_sendFrame
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-reentrant
+ * Parameters (in): type - The frame type
+ *                  payload - The payload bytes
+ *                  length - The payload length, up to LINK_MAX_PAYLOAD
+ * Parameters (inout): None
+ * Parameters (out): None
+ * Return value: None
+ * Description: Sends the start byte, the header, the payload and the checksum.
+ *              A payload too long for the receiver is not sent.
+ *******************************************************************************/
+void Link_sendFrame(uint8 type, const uint8 *payload, uint8 length)
+{
+	uint8 sum;
+	uint8 i;
+
+	if (length > LINK_MAX_PAYLOAD)
+	{
+		return;
+	}
+
+	UART_sendByte(LINK_FRAME_START);
+	UART_sendByte(type);
+	UART_sendByte(length);
+	sum = type + length;
+	for (i = 0; i < length; i++)
+	{
+		UART_sendByte(payload[i]);
+		sum += payload[i];
+	}
+	UART_sendByte((uint8)(0 - sum));
+}
+
+/******************************************************************************
+ * Service Name: Link_resetReceiver
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters (in): None
+ * Parameters (inout): receiver - The receiver
+ * Parameters (out): None
+ * Return value: None
+ * Description: Drops the frame being received, if any.
+ *******************************************************************************/
+void Link_resetReceiver(Link_ReceiverType *receiver)
+{
+	receiver->state = LINK_WAIT_START;
+}
+
+/******************************************************************************
+ * Service Name: Link_receiveByte
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters (in): data - The received byte
+ * Parameters (inout): receiver - The receiver
+ * Parameters (out): None
+ * Return value: Link_ResultType - What the byte was used for
+ * Description: Feeds one received byte to the receiver, never waits. A length
+ *              above LINK_MAX_PAYLOAD or a wrong checksum drops the frame. A
+ *              start byte in place of the checksum starts a new frame.
+ *******************************************************************************/
+Link_ResultType Link_receiveByte(Link_ReceiverType *receiver, uint8 data)
+{
+	switch (receiver->state)
+	{
+	case LINK_WAIT_TYPE:
+		receiver->type = data;
+		receiver->sum = data;
+		receiver->state = LINK_WAIT_LENGTH;
+		return LINK_IN_FRAME;
+
+	case LINK_WAIT_LENGTH:
+		if (data > LINK_MAX_PAYLOAD)
+		{
+			receiver->state = LINK_WAIT_START;
+			return LINK_FRAME_ERROR;
+		}
+		receiver->length = data;
+		receiver->index = 0;
+		receiver->sum += data;
+		receiver->state = (data == 0) ? LINK_WAIT_CHECKSUM : LINK_WAIT_PAYLOAD;
+		return LINK_IN_FRAME;
+
+	case LINK_WAIT_PAYLOAD:
+		receiver->payload[receiver->index++] = data;
+		receiver->sum += data;
+		if (receiver->index == receiver->length)
+		{
+			receiver->state = LINK_WAIT_CHECKSUM;
+		}
+		return LINK_IN_FRAME;
+
+	case LINK_WAIT_CHECKSUM:
+		if ((uint8)(receiver->sum + data) == 0)
+		{
+			receiver->state = LINK_WAIT_START;
+			return LINK_FRAME_OK;
+		}
+		/* A lost byte makes the next start byte land here, keep its frame */
+		receiver->state = (data == LINK_FRAME_START) ? LINK_WAIT_TYPE : LINK_WAIT_START;
+		return LINK_FRAME_ERROR;
+
+	default:
+		if (data != LINK_FRAME_START)
+		{
+			return LINK_NOT_FRAME;
+		}
+		receiver->state = LINK_WAIT_TYPE;
+		return LINK_IN_FRAME;
+	}
+}
@@ -0,0 +1,23 @@
+ /******************************************************************************
+ *
+ * Module: NVM Layout
+ *
+ * File Name: nvm_layout.h
+ *
+ * Description: Addresses of every block kept in the internal EEPROM
+ *
+ * Author: Mohamed Hisham
+ *
+ *******************************************************************************/
+
+#ifndef NVM_LAYOUT_H_
+#define NVM_LAYOUT_H_
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* Runtime configuration block (sizeof(Config_Type) bytes) */
+#define NVM_CONFIG_ADDRESS			0x0010
+
+#endif /* NVM_LAYOUT_H_ */
@@ -0,0 +1,201 @@
+ /******************************************************************************
+ *
+ * Module: Scheduler
+ *
+ * File Name: scheduler.c
+ *
+ * Description: Source file for the cooperative tick driven task scheduler
+ *
+ * Author: Mohamed Hisham
+ *
+ *******************************************************************************/
+
+#include "scheduler.h"
+#include "timebase.h"
+#include "soft_timer.h"
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <avr/sleep.h>
+
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+
+typedef struct {
+	Scheduler_TaskType task;
+	uint16 period;
+	uint32 nextRelease;
+	uint16 overruns;
+} Scheduler_TaskControlType;
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+static Scheduler_TaskControlType g_tasks[SCHEDULER_MAX_TASKS];
+static uint8 g_tasksCount = 0;
+
+/*******************************************************************************
+ *                      Private Functions Definitions                          *
+ *******************************************************************************/
+
+/* Signed difference keeps the comparison right when the time wraps */
+static boolean Scheduler_isReleased(const Scheduler_TaskControlType *task_ptr, uint32 now)
+{
+	return ((sint32)(now - task_ptr->nextRelease) >= 0) ? TRUE : FALSE;
+}
+
+static boolean Scheduler_isAnyTaskReleased(uint32 now)
+{
+	uint8 i;
+
+	for (i = 0; i < g_tasksCount; i++)
+	{
+		if (Scheduler_isReleased(&g_tasks[i], now))
+		{
+			return TRUE;
+		}
+	}
+
+	return FALSE;
+}
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+/******************************************************************************
+ * Service Name: Scheduler_init
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-reentrant
+ * Parameters (in): None
+ * Parameters (inout): None
+ * Parameters (out): None
+ * Return value: None
+ * Description: Prepares the idle sleep mode and empties the software timers.
+ *              The tasks are released from the time base, Time_init must be
+ *              called first.
+ *******************************************************************************/
+void Scheduler_init(void)
+{
+	SoftTimer_init();
+
+	/* Idle mode keeps the timers, UART and ADC running */
+	set_sleep_mode(SLEEP_MODE_IDLE);
+}
+
+/******************************************************************************
+ * Service Name: Scheduler_addTask
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-reentrant
+ * Parameters (in): task - The function to run, it must run to completion
+ *                  period - Time between two releases in milliseconds
+ *                  offset - Time before the first release in milliseconds
+ * Parameters (inout): None
+ * Parameters (out): None
+ * Return value: uint8 - Task ID, SCHEDULER_INVALID_TASK if there is no free slot
+ * Description: Registers a periodic task. Tasks registered first have the
+ *              highest priority when several tasks are released together.
+ *******************************************************************************/
+uint8 Scheduler_addTask(Scheduler_TaskType task, uint16 period, uint16 offset)
+{
+	if ((task == NULL_PTR) || (period == 0) || (g_tasksCount >= SCHEDULER_MAX_TASKS))
+	{
+		return SCHEDULER_INVALID_TASK;
+	}
+
+	g_tasks[g_tasksCount].task = task;
+	g_tasks[g_tasksCount].period = period;
+	g_tasks[g_tasksCount].nextRelease = Time_nowMs() + offset;
+	g_tasks[g_tasksCount].overruns = 0;
+
+	return g_tasksCount++;
+}
+
+/******************************************************************************
+ * Service Name: Scheduler_start
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-reentrant
+ * Parameters (in): None
+ * Parameters (inout): None
+ * Parameters (out): None
+ * Return value: None
+ * Description: Each pass first handles the expired software timers, then runs
+ *              the highest priority released task and starts again. When a
+ *              pass finds nothing to run, the CPU sleeps until the next
+ *              interrupt. The last check is done with the interrupts disabled
+ *              and the sleep instruction follows the sei instruction, so a
+ *              tick arriving after the check still wakes the CPU up.
+ *******************************************************************************/
+void Scheduler_start(void)
+{
+	Scheduler_TaskControlType *task_ptr;
+	uint32 now;
+	boolean ran;
+	uint8 i;
+
+	while(1)
+	{
+		ran = FALSE;
+		SoftTimer_process();
+		now = Time_nowMs();
+
+		for (i = 0; i < g_tasksCount; i++)
+		{
+			task_ptr = &g_tasks[i];
+
+			if (Scheduler_isReleased(task_ptr, now))
+			{
+				task_ptr->task();
+				task_ptr->nextRelease += task_ptr->period;
+
+				now = Time_nowMs();
+				if (Scheduler_isReleased(task_ptr, now))
+				{
+					/* Next release already missed, drop the missed releases */
+					task_ptr->overruns++;
+					do {
+						task_ptr->nextRelease += task_ptr->period;
+					} while (Scheduler_isReleased(task_ptr, now));
+				}
+
+				ran = TRUE;
+				break;
+			}
+		}
+
+		if (!ran)
+		{
+			cli();
+			if (!SoftTimer_isPending() && !Scheduler_isAnyTaskReleased(Time_nowMs()))
+			{
+				sleep_enable();
+				sei();
+				sleep_cpu();
+				sleep_disable();
+			}
+			sei();
+		}
+	}
+}
+
+/******************************************************************************
+ * Service Name: Scheduler_getOverruns
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters (in): id - Task ID returned by Scheduler_addTask
+ * Parameters (inout): None
+ * Parameters (out): None
+ * Return value: uint16 - Number of times the task missed its next release
+ * Description: A task overruns when it is still running, or was not started,
+ *              at the time of its next release. The missed releases are dropped.
+ *******************************************************************************/
+uint16 Scheduler_getOverruns(uint8 id)
+{
+	if (id >= g_tasksCount)
+	{
+		return 0;
+	}
+
+	return g_tasks[id].overruns;
+}
@@ -0,0 +1,94 @@
+ /******************************************************************************
+ *
+ * Module: Scheduler
+ *
+ * File Name: scheduler.h
+ *
+ * Description: Header file for the cooperative tick driven task scheduler
+ *
+ * Author: Mohamed Hisham
+ *
+ *******************************************************************************/
+
+#ifndef SCHEDULER_H_
+#define SCHEDULER_H_
+
+#include "..\std_types.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* Maximum number of tasks that can be registered */
+#define SCHEDULER_MAX_TASKS		6
+
+/* Returned by Scheduler_addTask when the task cannot be registered */
+#define SCHEDULER_INVALID_TASK	0xFF
+
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+
+typedef void (*Scheduler_TaskType)(void);
+
+/*******************************************************************************
+ *                              Functions Prototypes                           *
+ *******************************************************************************/
+
+/******************************************************************************
+ * Service Name: Scheduler_init
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-reentrant
+ * Parameters (in): None
+ * Parameters (inout): None
+ * Parameters (out): None
+ * Return value: None
+ * Description: Prepares the idle sleep mode and empties the software timers,
+ *              which must be created after this call. Time_init must be called
+ *              first.
+ *******************************************************************************/
+void Scheduler_init(void);
+
+/******************************************************************************
+ * Service Name: Scheduler_addTask
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-reentrant
+ * Parameters (in): task - The function to run, it must run to completion
+ *                  period - Time between two releases in milliseconds
+ *                  offset - Time before the first release in milliseconds
+ * Parameters (inout): None
+ * Parameters (out): None
+ * Return value: uint8 - Task ID, SCHEDULER_INVALID_TASK if there is no free slot
+ * Description: Registers a periodic task. Tasks registered first have the
+ *              highest priority when several tasks are released together.
+ *******************************************************************************/
+uint8 Scheduler_addTask(Scheduler_TaskType task, uint16 period, uint16 offset);
+
+/******************************************************************************
+ * Service Name: Scheduler_start
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-reentrant
+ * Parameters (in): None
+ * Parameters (inout): None
+ * Parameters (out): None
+ * Return value: None
+ * Description: Runs the software timer callbacks and the released tasks
+ *              forever, sleeping in idle mode whenever nothing is ready. Never
+ *              returns.
+ *******************************************************************************/
+void Scheduler_start(void);
+
+/******************************************************************************
+ * Service Name: Scheduler_getOverruns
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters (in): id - Task ID returned by Scheduler_addTask
+ * Parameters (inout): None
+ * Parameters (out): None
+ * Return value: uint16 - Number of times the task missed its next release
+ * Description: A task overruns when it is still running, or was not started,
+ *              at the time of its next release. The missed releases are dropped.
+ *******************************************************************************/
+uint16 Scheduler_getOverruns(uint8 id);
+
+#endif /* SCHEDULER_H_ */
@@ -0,0 +1,150 @@
+ /******************************************************************************
+ *
+ * Module: Sequencer
+ *
+ * File Name: sequencer.c
+ *
+ * Description: Source file for the non-blocking timed actuator sequencer
+ *
+ * Author: Mohamed Hisham
+ *
+ *******************************************************************************/
+
+#include "sequencer.h"
+#include "soft_timer.h"
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+static const Sequencer_StepType *g_steps = NULL_PTR;
+static uint8 g_stepsCount = 0;
+static uint8 g_stepIndex = 0;     /* Step to run next */
+static uint8 g_stepRuns = 0;      /* Runs of the current step already done */
+static Sequencer_ActionType g_done = NULL_PTR;
+static boolean g_running = FALSE;
+static uint8 g_timer = SOFT_TIMER_INVALID;
+
+/*******************************************************************************
+ *                      Private Functions Definitions                          *
+ *******************************************************************************/
+
+/*
+ * Runs the steps until one has to wait, then arms the one-shot timer that
+ * calls this function again. Runs in thread context only.
+ */
+static void Sequencer_next(void)
+{
+	const Sequencer_StepType *step_ptr;
+
+	while (g_stepIndex < g_stepsCount)
+	{
+		step_ptr = &g_steps[g_stepIndex];
+
+		if (++g_stepRuns >= step_ptr->count)
+		{
+			g_stepRuns = 0;
+			g_stepIndex++;
+		}
+
+		if (step_ptr->action != NULL_PTR)
+		{
+			step_ptr->action();
+		}
+
+		if (step_ptr->duration != 0)
+		{
+			SoftTimer_start(g_timer, step_ptr->duration, 0);
+			return;
+		}
+	}
+
+	g_running = FALSE;
+	if (g_done != NULL_PTR)
+	{
+		g_done();
+	}
+}
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+/******************************************************************************
+ * Service Name: Sequencer_init
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-reentrant
+ * Parameters (in): None
+ * Parameters (inout): None
+ * Parameters (out): None
+ * Return value: None
+ * Description: Creates the software timer that times the steps, must be called
+ *              after Scheduler_init.
+ *******************************************************************************/
+void Sequencer_init(void)
+{
+	g_timer = SoftTimer_create(Sequencer_next);
+}
+
+/******************************************************************************
+ * Service Name: Sequencer_start
+ * Sync/Async: Asynchronous
+ * Reentrancy: Non-reentrant
+ * Parameters (in): steps - The steps to run, kept in use until the sequence ends
+ *                  count - Number of steps
+ *                  done - Called after the last step, may be NULL_PTR
+ * Parameters (inout): None
+ * Parameters (out): None
+ * Return value: None
+ * Description: Runs the steps up to the first one that waits, the rest of the
+ *              sequence is driven by a one-shot software timer.
+ *******************************************************************************/
+void Sequencer_start(const Sequencer_StepType *steps, uint8 count, Sequencer_ActionType done)
+{
+	if ((steps == NULL_PTR) || (g_timer == SOFT_TIMER_INVALID))
+	{
+		return;
+	}
+
+	SoftTimer_stop(g_timer);
+
+	g_steps = steps;
+	g_stepsCount = count;
+	g_stepIndex = 0;
+	g_stepRuns = 0;
+	g_done = done;
+	g_running = TRUE;
+
+	Sequencer_next();
+}
+
+/******************************************************************************
+ * Service Name: Sequencer_stop
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-reentrant
+ * Parameters (in): None
+ * Parameters (inout): None
+ * Parameters (out): None
+ * Return value: None
+ * Description: Cancels the sequence in progress, the done callback is not called.
+ *******************************************************************************/
+void Sequencer_stop(void)
+{
+	SoftTimer_stop(g_timer);
+	g_running = FALSE;
+}
+
+/******************************************************************************
+ * Service Name: Sequencer_isRunning
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters (in): None
+ * Parameters (inout): None
+ * Parameters (out): None
+ * Return value: boolean - TRUE while a sequence is in progress
+ * Description: Tells if a sequence is in progress.
+ *******************************************************************************/
+boolean Sequencer_isRunning(void)
+{
+	return g_running;
+}
@@ -0,0 +1,87 @@
+ /******************************************************************************
+ *
+ * Module: Sequencer
+ *
+ * File Name: sequencer.h
+ *
+ * Description: Header file for the non-blocking timed actuator sequencer
+ *
+ * Author: Mohamed Hisham
+ *
+ *******************************************************************************/
+
+#ifndef SEQUENCER_H_
+#define SEQUENCER_H_
+
+#include "..\std_types.h"
+
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+
+typedef void (*Sequencer_ActionType)(void);
+
+typedef struct {
+	Sequencer_ActionType action;  /* Called when the step starts, NULL_PTR for a plain wait */
+	uint16 duration;              /* Time in ms before the next step, 0 to go on at once */
+	uint8 count;                  /* Number of times the step runs in a row */
+} Sequencer_StepType;
+
+/*******************************************************************************
+ *                              Functions Prototypes                           *
+ *******************************************************************************/
+
+/******************************************************************************
+ * Service Name: Sequencer_init
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-reentrant
+ * Parameters (in): None
+ * Parameters (inout): None
+ * Parameters (out): None
+ * Return value: None
+ * Description: Creates the software timer that times the steps, must be called
+ *              after Scheduler_init.
+ *******************************************************************************/
+void Sequencer_init(void);
+
+/******************************************************************************
+ * Service Name: Sequencer_start
+ * Sync/Async: Asynchronous
+ * Reentrancy: Non-reentrant
+ * Parameters (in): steps - The steps to run, kept in use until the sequence ends
+ *                  count - Number of steps
+ *                  done - Called after the last step, may be NULL_PTR
+ * Parameters (inout): None
+ * Parameters (out): None
+ * Return value: None
+ * Description: Starts the sequence from its first step, cancelling a sequence
+ *              in progress. Returns after the first step is started, the next
+ *              steps run from the software timer.
+ *******************************************************************************/
+void Sequencer_start(const Sequencer_StepType *steps, uint8 count, Sequencer_ActionType done);
+
+/******************************************************************************
+ * Service Name: Sequencer_stop
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-reentrant
+ * Parameters (in): None
+ * Parameters (inout): None
+ * Parameters (out): None
+ * Return value: None
+ * Description: Cancels the sequence in progress, the done callback is not called.
+ *******************************************************************************/
+void Sequencer_stop(void);
+
+/******************************************************************************
+ * Service Name: Sequencer_isRunning
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters (in): None
+ * Parameters (inout): None
+ * Parameters (out): None
+ * Return value: boolean - TRUE while a sequence is in progress
+ * Description: Tells if a sequence is in progress.
+ *******************************************************************************/
+boolean Sequencer_isRunning(void);
+
+#endif /* SEQUENCER_H_ */
@@ -0,0 +1,134 @@
+ /******************************************************************************
+ *
+ * Module: Software Timers
+ *
+ * File Name: soft_timer.h
+ *
+ * Description: Header file for the software timers driven by the system tick
+ *
+ * Author: Mohamed Hisham
+ *
+ *******************************************************************************/
+
+#ifndef SOFT_TIMER_H_
+#define SOFT_TIMER_H_
+
+#include "..\std_types.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* Maximum number of software timers that can be created */
+#define SOFT_TIMER_MAX_TIMERS		8
+
+/* Number of slots of the timing wheel, must be a power of 2 */
+#define SOFT_TIMER_WHEEL_SIZE		8
+
+/* Returned by SoftTimer_create when the timer cannot be created */
+#define SOFT_TIMER_INVALID			0xFF
+
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+
+typedef void (*SoftTimer_CallbackType)(void);
+
+/*******************************************************************************
+ *                              Functions Prototypes                           *
+ *******************************************************************************/
+
+/******************************************************************************
+ * Service Name: SoftTimer_init
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-reentrant
+ * Parameters (in): None
+ * Parameters (inout): None
+ * Parameters (out): None
+ * Return value: None
+ * Description: Empties the timing wheel, called by Scheduler_init. The timers
+ *              count the ticks of the time base, Time_init must be called first.
+ *******************************************************************************/
+void SoftTimer_init(void);
+
+/******************************************************************************
+ * Service Name: SoftTimer_create
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-reentrant
+ * Parameters (in): callback - Function called each time the timer expires
+ * Parameters (inout): None
+ * Parameters (out): None
+ * Return value: uint8 - Timer ID, SOFT_TIMER_INVALID if there is no free timer
+ * Description: Creates a stopped timer. The callback runs in thread context
+ *              from SoftTimer_process, never from the tick interrupt.
+ *******************************************************************************/
+uint8 SoftTimer_create(SoftTimer_CallbackType callback);
+
+/******************************************************************************
+ * Service Name: SoftTimer_start
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-reentrant
+ * Parameters (in): id - Timer ID returned by SoftTimer_create
+ *                  timeout - Time before the first expiry in milliseconds
+ *                  period - Time between the next expiries in milliseconds,
+ *                           0 for a one-shot timer
+ * Parameters (inout): None
+ * Parameters (out): None
+ * Return value: None
+ * Description: Arms the timer, restarting it if it is already running. The
+ *              times are rounded up to whole ticks.
+ *******************************************************************************/
+void SoftTimer_start(uint8 id, uint16 timeout, uint16 period);
+
+/******************************************************************************
+ * Service Name: SoftTimer_stop
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-reentrant
+ * Parameters (in): id - Timer ID returned by SoftTimer_create
+ * Parameters (inout): None
+ * Parameters (out): None
+ * Return value: None
+ * Description: Stops the timer, its callback is not called until it is started
+ *              again.
+ *******************************************************************************/
+void SoftTimer_stop(uint8 id);
+
+/******************************************************************************
+ * Service Name: SoftTimer_isRunning
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters (in): id - Timer ID returned by SoftTimer_create
+ * Parameters (inout): None
+ * Parameters (out): None
+ * Return value: boolean - TRUE if the timer is armed
+ * Description: Tells if the timer is armed. A one-shot timer stops once it
+ *              has expired.
+ *******************************************************************************/
+boolean SoftTimer_isRunning(uint8 id);
+
+/******************************************************************************
+ * Service Name: SoftTimer_isPending
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters (in): None
+ * Parameters (inout): None
+ * Parameters (out): None
+ * Return value: boolean - TRUE if ticks are waiting for SoftTimer_process
+ * Description: Tells if SoftTimer_process has ticks to handle.
+ *******************************************************************************/
+boolean SoftTimer_isPending(void);
+
+/******************************************************************************
+ * Service Name: SoftTimer_process
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-reentrant
+ * Parameters (in): None
+ * Parameters (inout): None
+ * Parameters (out): None
+ * Return value: None
+ * Description: Advances the timing wheel to the current tick and calls the
+ *              callbacks of the expired timers. Called from the scheduler loop.
+ *******************************************************************************/
+void SoftTimer_process(void);
+
+#endif /* SOFT_TIMER_H_ */
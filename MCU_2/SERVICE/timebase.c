@@ -0,0 +1,148 @@
+ /******************************************************************************
+ *
+ * Module: Time Base
+ *
+ * File Name: timebase.c
+ *
+ * Description: Source file for the monotonic system time base
+ *
+ * Author: Mohamed Hisham
+ *
+ *******************************************************************************/
+
+#include "timebase.h"
+#include "timebase_isr.h"
+#include "../MCAL/timer2.h"
+#include "../MCAL/isr_config.h"
+#include <avr/io.h>
+#include <avr/interrupt.h>
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+/* Advanced by Time_tick in timebase_isr.h */
+volatile uint32 g_timeMs = 0;         /* Milliseconds counted at the last tick */
+volatile uint16 g_timeFractionUs = 0; /* Microseconds not yet counted in g_timeMs */
+volatile uint32 g_timeUs = 0;         /* Microseconds counted at the last tick */
+volatile uint16 g_ticks = 0;          /* Ticks counted since Time_init */
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+/******************************************************************************
+ * Service Name: Time_init
+ * Sync/Async: Synchronous
+ * Reentrancy: Non-reentrant
+ * Parameters (in): None
+ * Parameters (inout): None
+ * Parameters (out): None
+ * Return value: None
+ * Description: One interrupt every 8.192ms keeps the time base cost well
+ *              below 1% of the CPU. The tick is called through the Timer2
+ *              callback unless it is bound to the vector in isr_config.h.
+ *******************************************************************************/
+void Time_init(void)
+{
+	Timer2_ConfigType timer_config;
+
+	timer_config.initial_value = 0;
+	timer_config.compare_value = 0;
+	timer_config.mode = TIMER2_NORMAL_MODE;
+	timer_config.prescaler = TIMER2_PRESCALER_32;
+
+#ifndef TIMER2_OVF_HANDLER
+	Timer2_setCallBack(Time_tick);
+#endif
+	Timer2_init(&timer_config);
+}
+
+/******************************************************************************
+ * Service Name: Time_nowMs
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters (in): None
+ * Parameters (inout): None
+ * Parameters (out): None
+ * Return value: uint32 - Milliseconds since Time_init
+ * Description: Adds the microseconds of the Timer2 count to the ones carried
+ *              by the tick, the same way as Time_nowUs, so the clock moves
+ *              between the ticks. The fraction stays below 17.4ms and is
+ *              summed in 16 bits.
+ *******************************************************************************/
+uint32 Time_nowMs(void)
+{
+	uint32 time;
+	uint16 fraction;
+	uint8 count;
+	uint8 sreg = SREG;
+
+	cli();
+	time = g_timeMs;
+	fraction = g_timeFractionUs;
+	count = TCNT2;
+	if ((TIFR & (1<<TOV2)) && (count != 0xFF))
+	{
+		/* Overflow not serviced yet, the count read belongs to the next tick */
+		fraction += TIME_TICK_US;
+	}
+	SREG = sreg;
+
+	fraction += (uint16)count * TIME_COUNT_US;
+
+	return time + (fraction / 1000);
+}
+
+/******************************************************************************
+ * Service Name: Time_nowUs
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters (in): None
+ * Parameters (inout): None
+ * Parameters (out): None
+ * Return value: uint32 - Microseconds since Time_init
+ * Description: Adds the Timer2 count to the time of the last tick. If the
+ *              timer overflowed while the interrupts were disabled, the tick
+ *              is still pending and is added here.
+ *******************************************************************************/
+uint32 Time_nowUs(void)
+{
+	uint32 time;
+	uint8 count;
+	uint8 sreg = SREG;
+
+	cli();
+	time = g_timeUs;
+	count = TCNT2;
+	if ((TIFR & (1<<TOV2)) && (count != 0xFF))
+	{
+		/* Overflow not serviced yet, the count read belongs to the next tick */
+		time += TIME_TICK_US;
+	}
+	SREG = sreg;
+
+	return time + ((uint32)count * TIME_COUNT_US);
+}
+
+/******************************************************************************
+ * Service Name: Time_nowTicks
+ * Sync/Async: Synchronous
+ * Reentrancy: Reentrant
+ * Parameters (in): None
+ * Parameters (inout): None
+ * Parameters (out): None
+ * Return value: uint16 - Ticks since Time_init
+ * Description: Returns the raw tick count, read with the interrupts disabled.
+ *******************************************************************************/
+uint16 Time_nowTicks(void)
+{
+	uint16 ticks;
+	uint8 sreg = SREG;
+
+	cli();
+	ticks = g_ticks;
+	SREG = sreg;
+
+	return ticks;
+}
@@ -0,0 +1,51 @@
+ /******************************************************************************
+ *
+ * Module: Time Base
+ *
+ * File Name: timebase_isr.h
+ *
+ * Description: Inline tick handler of the time base, bound to the Timer2
+ *              overflow vector in isr_config.h
+ *
+ * Author: Mohamed Hisham
+ *
+ *******************************************************************************/
+
+#ifndef TIMEBASE_ISR_H_
+#define TIMEBASE_ISR_H_
+
+#include "timebase.h"
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+/* Owned by timebase.c, only written by Time_tick */
+extern volatile uint32 g_timeMs;
+extern volatile uint16 g_timeFractionUs;
+extern volatile uint32 g_timeUs;
+extern volatile uint16 g_ticks;
+
+/*******************************************************************************
+ *                              Functions Definitions                          *
+ *******************************************************************************/
+
+/*
+ * Timer2 overflow handler. The tick is not a whole number of milliseconds,
+ * the remainder is carried so the millisecond clock does not drift.
+ */
+static inline __attribute__((always_inline)) void Time_tick(void)
+{
+	g_ticks++;
+	g_timeUs += TIME_TICK_US;
+
+	g_timeMs += (TIME_TICK_US / 1000);
+	g_timeFractionUs += (TIME_TICK_US % 1000);
+	if (g_timeFractionUs >= 1000)
+	{
+		g_timeFractionUs -= 1000;
+		g_timeMs++;
+	}
+}
+
+#endif /* TIMEBASE_ISR_H_ */